@@ -5,6 +5,7 @@ CONFIG += ordered
 SUBDIRS += libraries
 SUBDIRS += kernel
 SUBDIRS += application
+SUBDIRS += cli
 SUBDIRS += plugins
 
 #SUBDIRS += tests
@@ -78,7 +78,7 @@ QVariant ModelTMY::data(const QModelIndex& index, int role) const
         int c = index.column();
         int n = m_filter.indexA + r;
         if (n >= m_formatTMY->data().size()) n -= m_formatTMY->data().size();
-        return m_formatTMY->data()[n].data.section(',', c, c);
+        return m_formatTMY->table().text(n, c);
     } else if (role == Qt::TextAlignmentRole) {
         return Qt::AlignRight;
     }
@@ -1,8 +1,9 @@
 #include "ReaderTMY.h"
 
-#include <QFile>
 #include <QStringList>
 
+#include <cmath>
+
 #include "ParameterItem.h"
 #include "SunPathLib/calculators/SunCalculatorMB.h"
 #include "../DaysEdit/DaysModel.h"
@@ -12,15 +13,6 @@ using Qt::endl;
 namespace sp {
 
 
-int readInt(const QStringList& list, int n)
-{
-    if (n < 0) return 0;
-    bool ok;
-    int ans = list[n].toInt(&ok);
-    if (!ok) throw QString("toInt at %1 of \n").arg(n) + list.join(',');
-    return ans;
-}
-
 double readDouble(const QStringList& list, int n)
 {
     if (n < 0) return 0.;
@@ -76,13 +68,9 @@ bool ReaderTMY::read(QString fileName)
     try {
         m_message.clear();
 
-        QFile file(fileName);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            throw QString("File not opened: ") + fileName;
-
-        QTextStream fin(&file);
-        readInfo(fin);
-        readData(fin);
+        m_table.read(fileName, 3);
+        readInfo();
+        readData();
         return true;
     }
     catch (const QString& message) {
@@ -122,11 +110,11 @@ void ReaderTMY::setDNI(QString name)
     int n = m_recordsInfo.names.indexOf(name);
     if (n < 0) return;
 
-    bool ok;
-        for (RecordTMY& r : m_data) {
-        double dni = r.data.section(',', n, n).toDouble(&ok);
-//        if (!ok) throw QString("toDouble ") + line;
-        r.DNI = dni;
+    const QVector<double>& column = m_table.column(n); // parsed once in read
+    for (int i = 0; i < m_data.size(); ++i) {
+        double dni = column[i];
+        if (std::isnan(dni)) dni = 0.;
+        m_data[i].DNI = dni;
     }
 
     m_recordsInfo.min = std::min_element(m_data.begin(), m_data.end(),
@@ -186,19 +174,10 @@ void ReaderTMY::setDNI(QString name)
     m_paramsEffective->parameterAbstract("Checks.Hour 0 as 24")->setText(hoursAscending? "false" : "true");
 }
 
-void ReaderTMY::readInfo(QTextStream& fin)
+void ReaderTMY::readInfo()
 {
-    // line 1
-    QString line = fin.readLine();
-    if (line.isNull())
-        throw QString("line 1 is missing");
-    m_infoNames = line.split(',');
-
-    // line 2
-    line = fin.readLine();
-    if (line.isNull())
-        throw QString("line 2 is missing");
-    m_info = line.split(',');
+    m_infoNames = m_table.header(0); // line 1
+    m_info = m_table.header(1); // line 2
 
     if (m_infoNames.size() != m_info.size())
         throw QString("line 1 and 2 have a different number of elements");
@@ -289,15 +268,10 @@ void ReaderTMY::readInfo(QTextStream& fin)
     }
 }
 
-void ReaderTMY::readData(QTextStream& fin)
+void ReaderTMY::readData()
 {
-    // line 3
-    QString line = fin.readLine();
-    if (line.isNull())
-        throw QString("line 3 is missing");
-
     QStringList& names = m_recordsInfo.names;
-    names = line.split(',');
+    names = m_table.header(2); // line 3
 
     int iYear = -1;
     int iMonth = -1;
@@ -321,37 +295,29 @@ void ReaderTMY::readData(QTextStream& fin)
             iSecond = i;
     }
 
-    int year = 0;
-    int month = 0;
-    int day = 0;
-    int hour = 0;
-    int minute = 0;
-    int second = 0;
-
-    m_data.clear();
-    RecordTMY record;
-    while (true) {
-        QString line = fin.readLine();
-        if (line.isNull()) break;
-
-        QStringList list = line.split(',');
-        if (list.size() != names.size())
-            throw QString("line 3 and N have a different number of elements");
-
-        year = readInt(list, iYear);
-        month = readInt(list, iMonth);
-        day = readInt(list, iDay);
-        hour = readInt(list, iHour);
-        minute = readInt(list, iMinute);
-        second = readInt(list, iSecond);
+    int columns[] = {iYear, iMonth, iDay, iHour, iMinute, iSecond};
+    int values[6];
+
+    m_data.resize(m_table.rows());
+    for (int n = 0; n < m_data.size(); ++n) {
+        for (int k = 0; k < 6; ++k) {
+            int i = columns[k];
+            if (i < 0) {
+                values[k] = 0;
+                continue;
+            }
+            double v = m_table.column(i)[n];
+            if (std::isnan(v))
+                throw QString("toInt at %1 of \n").arg(i) + m_table.text(n, i);
+            values[k] = int(v);
+        }
 
+        RecordTMY& record = m_data[n];
         record.time = QDateTime(
-            QDate(year, month, day),
-            QTime(hour, minute, second),
+            QDate(values[0], values[1], values[2]),
+            QTime(values[3], values[4], values[5]),
             Qt::UTC
         );
-        record.data = line;
-        m_data << record;
     }
 
     setDNI("DNI");
@@ -6,6 +6,7 @@
 
 #include <QStandardItemModel>
 #include "ParameterModel.h"
+#include "SunPathLib/data/TableCSV.h"
 class TreeItem;
 
 namespace sp {
@@ -16,7 +17,6 @@ struct RecordTMY
     QDateTime time; // local, but saved as UTC0
     int stamp; // timestamp in seconds from year start
     double DNI;
-    QString data;
 };
 
 struct RecordsInfo
@@ -59,14 +59,15 @@ public:
 
     RecordsInfo& recordsInfo() {return m_recordsInfo;}
     QVector<RecordTMY>& data() {return m_data;}
+    const TableCSV& table() const {return m_table;}
     int findIndex(QDate date);
     int findIndexStamp(int stamp);
     int findStamp(QDate date);
     void setDNI(QString name);
 
 protected:
-    void readInfo(QTextStream& fin);
-    void readData(QTextStream& fin);
+    void readInfo();
+    void readData();
     double calculateDNIbelow(double origin);
     bool isTimeSorted();
 
@@ -79,6 +80,7 @@ protected:
     QStringList m_info; // line 2
 
     RecordsInfo m_recordsInfo;
+    TableCSV m_table; // columns of lines 4..
     QVector<RecordTMY> m_data; // lines 4..
 };
 
@@ -34,7 +34,6 @@ HEADERS += \
     main/Document.h \
     main/LineEditPlaceHolder.h \
     main/MainWindow.h \
-    main/PluginManager.h \
     main/UndoView.h \
     parameters/ComboBoxDelegate.h \
     parameters/ParametersDelegate.h \
@@ -101,7 +100,6 @@ SOURCES += \
     main/Document.cpp \
     main/LineEditPlaceHolder.cpp \
     main/MainWindow.cpp \
-    main/PluginManager.cpp \
     main/UndoView.cpp \
     main/main.cpp \
     parameters/ComboBoxDelegate.cpp \
@@ -9,6 +9,7 @@
 
 #include "Document.h"
 #include "kernel/scene/TSceneKit.h"
+#include "kernel/shape/PolygonMeshCache.h"
 #include "application/view/GraphicRoot.h"
 
 /*!
@@ -39,38 +40,10 @@ bool Document::ReadFile(const QString& fileName)
     if (fileName.isEmpty())
         return false;
 
-    SoInput input;
-
-    if (!input.openFile(fileName.toLatin1().data()))
-    {
-        QString message = QString("Cannot open file %1.").arg(fileName);
-        emit Warning(message);
-        return false;
-    }
-
-    if (!input.isValidFile())
-    {
-        QString message = QString("Error reading file %1.").arg(fileName);
-        emit Warning(message);
-        return false;
-    }
-
-    SoSeparator* separator = SoDB::readAll(&input);
-    input.closeFile();
-
-    if (!separator)
+    QString message;
+    TSceneKit* scene = TSceneKit::readFile(fileName, message);
+    if (!scene)
     {
-        QString message = QString("Error reading file %1.").arg(fileName);
-        emit Warning(message);
-        return false;
-    }
-
-    TSceneKit* scene = dynamic_cast<TSceneKit*>(separator->getChild(0));
-    if (!scene) return false;
-
-    QString version = ((SoSFString*)scene->getField("version"))->getValue().getString();
-    if (version != "2020") {
-        QString message = QString("Version %1 is not compatible.").arg(version);
         emit Warning(message);
         return false;
     }
@@ -121,5 +94,6 @@ void Document::ClearScene()
 {
     while (m_scene->getRefCount() > 1) //? >=
         m_scene->unref();
+    PolygonMeshCache::clear();
 }
 
@@ -9,7 +9,6 @@
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QMessageBox>
-#include <QMutex>
 #include <QPluginLoader>
 #include <QProgressDialog>
 #include <QSettings>
@@ -58,7 +57,7 @@
 #include "commands/CmdSetFieldText.h"
 #include "commands/CmdPaste.h"
 
-#include "PluginManager.h"
+#include "kernel/node/PluginManager.h"
 #include "kernel/node/TonatiuhFunctions.h"
 #include "kernel/air/AirVacuum.h"
 #include "kernel/air/AirKit.h"
@@ -92,6 +91,9 @@
 #include "tree/SceneTreeModel.h"
 #include "view/GraphicRoot.h"
 #include "view/GraphicView.h"
+#include "view/OverlayNode.h"
+#include "view/SeparatorStyle.h"
+#include "view/SkyNode3D.h"
 #include "widgets/AboutDialog.h"
 #include "widgets/AirDialog.h"
 #include "widgets/NetworkConnectionsDialog.h"
@@ -158,6 +160,9 @@ MainWindow::MainWindow(QString fileName, CustomSplashScreen* splash, QWidget* pa
 
     if (splash) splash->setMessage("Loading plugins");
     m_pluginManager = new PluginManager;
+    SkyNode3D::initClass();
+    OverlayNode::initClass();
+    SeparatorStyle::initClass();
     QDir dir(qApp->applicationDirPath());
     dir.cd("plugins");
     m_pluginManager->load(dir);
@@ -1618,14 +1623,18 @@ QJSValue MainWindow::FindInterception(QJSValue surface, QJSValue rays, QJSValue
         m_rand = m_pluginManager->getRandomFactories()[m_raysRandomFactoryIndex]->create(0);
 
     FluxAnalysis fa(m_document->getSceneKit(), m_modelScene, m_raysGridWidth, m_raysGridHeight, m_rand);
+    if (show.toBool() == false) {
+        // photons are not needed
+        fa.runTally(surface.toString(), "front", rays.toUInt(), 5, 5);
+        return fa.powerTotal();
+    }
+
     fa.run(surface.toString(), "front", rays.toUInt(), false, 5, 5, true);
     double ans = fa.powerTotal();
 
-    if (show.toBool() == true) {
-         trf::DrawRays(m_graphicsRoot->rays(), *fa.getPhotonsBuffer(), m_raysScreen);
-        m_graphicsRoot->showRays(true);
-//       m_graphicView[0]->render();
-    }
+    trf::DrawRays(m_graphicsRoot->rays(), *fa.getPhotonsBuffer(), m_raysScreen);
+    m_graphicsRoot->showRays(true);
+//    m_graphicView[0]->render();
     return ans;
 }
 
@@ -1852,14 +1861,7 @@ void MainWindow::Run()
         return;
     }
 
-    QVector<long> raysPerThread;
-    int progressMax = 100;
-    ulong t1 = m_raysNumber/progressMax;
-    for (int progress = 0; progress < progressMax; ++progress)
-        raysPerThread << t1;
-
-    if (t1*progressMax < m_raysNumber)
-        raysPerThread << m_raysNumber - t1*progressMax;
+    QVector<RayTracer::Batch> raysPerThread = RayTracer::makeBatches(m_raysNumber);
 
 
 
@@ -1879,8 +1881,6 @@ void MainWindow::Run()
     connect(&watcher, SIGNAL(progressValueChanged(int)), &dialog, SLOT(setValue(int)));
 
     std::cout << "QtConcurrent started: " << timer.elapsed() << std::endl;
-    QMutex mutex;
-    QMutex mutexPhotonMap;
     QFuture<void> photonMap;
     AirTransmission* airTemp = 0;
     if (air->getTypeId() != AirVacuum::getClassTypeId())
@@ -1889,7 +1889,7 @@ void MainWindow::Run()
     photonMap = QtConcurrent::map(raysPerThread, RayTracer(instanceLayout,
                                                            &instanceSun, sunAperture, sunShape, airTemp,
                                                            m_rand,
-                                                           &mutex, m_photonsBuffer, &mutexPhotonMap,
+                                                           m_photonsBuffer,
                                                            exportSurfaceList) );
     watcher.setFuture(photonMap);
 
@@ -19,7 +19,7 @@
 #include "libraries/Coin3D/UserSField.h"
 #include "libraries/Coin3D/UserMField.h"
 #include "main/MainWindow.h"
-#include "main/PluginManager.h"
+#include "kernel/node/PluginManager.h"
 #include "kernel/node/TFactory.h"
 #include "kernel/node/TNode.h"
 
@@ -1,13 +1,13 @@
 #include "FluxAnalysis.h"
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
 #include <QFileDialog>
 #include <QFutureWatcher>
-#include <QMutex>
 #include <QPair>
-#include <QProgressDialog>
+#include <QThread>
 #include <QtConcurrentMap>
 
 #include <Inventor/actions/SoGetBoundingBoxAction.h>
@@ -18,6 +18,7 @@
 #include "kernel/air/AirTransmission.h"
 #include "kernel/run/InstanceNode.h"
 #include "kernel/photons/PhotonsBuffer.h"
+#include "kernel/photons/PhotonsTally.h"
 #include "kernel/random//Random.h"
 #include "kernel/run/RayTracer.h"
 #include "kernel/scene/TSceneKit.h"
@@ -51,7 +52,8 @@ FluxAnalysis::FluxAnalysis(TSceneKit* sceneKit,
     m_powerTotal(0.),
     m_powerPhoton(0.),
     m_photonsMax(0),
-    m_photonsError(0)
+    m_photonsError(0),
+    m_uvsPhotons(0)
 {
     m_instanceLayout = m_sceneModel->getInstance(QModelIndex());
     m_instanceLayout = m_instanceLayout->children[0];
@@ -88,29 +90,15 @@ QString FluxAnalysis::getShapeType(QString nodeURL)
  */
 void FluxAnalysis::run(QString nodeURL, QString surfaceSide, ulong nRays, bool photonBufferAppend, int uDivs, int vDivs, bool /*silent*/)
 {
+    if (nodeURL != m_surfaceURL || surfaceSide != m_surfaceSide || !photonBufferAppend) {
+        m_uvs.clear();
+        m_uvsPhotons = 0;
+    }
     m_surfaceURL = nodeURL;
     m_surfaceSide = surfaceSide;
 
     m_binsPhotons.resize(uDivs, vDivs);
 
-    if (!m_sceneKit) return;
-
-    AirTransmission* air = dynamic_cast<AirTransmission*>(m_sceneKit->getPart("world.air.transmission", false));
-
-    if (!m_instanceLayout) return;
-    InstanceNode* instanceScene = m_instanceLayout->getParent();
-    if (!instanceScene) return;
-
-    SunKit* sunKit = static_cast<SunKit*>(m_sceneKit->getPart("world.sun", false));
-    InstanceNode instanceSun(sunKit);
-
-    SunPosition* sunPosition = (SunPosition*) sunKit->getPart("position", false);
-    SunShape* sunShape = (SunShape*) sunKit->getPart("shape", false);
-    SunAperture* sunAperture = (SunAperture*) sunKit->getPart("aperture", false);
-    SoTransform* sunTransform = sunKit->m_transform;
-
-    if (!m_rand) return;
-
     //Check if the surface and the surface side defined is suitable
 //    QString shapeType = getShapeType(m_surfaceURL);
 //    QStringList list = {"Planar", "Cylinder"};
@@ -119,6 +107,9 @@ void FluxAnalysis::run(QString nodeURL, QString surfaceSide, ulong nRays, bool p
 //    if (m_surfaceSide != "front" && m_surfaceSide != "back")
 //        return;
 
+    InstanceNode* instanceNode = prepare();
+    if (!instanceNode) return;
+
     //Create the photon map where photons are going to be stored
     if (!m_photons || !photonBufferAppend)
     {
@@ -131,12 +122,67 @@ void FluxAnalysis::run(QString nodeURL, QString surfaceSide, ulong nRays, bool p
         m_powerTotal = 0;
     }
 
+    trace(instanceNode, nRays, m_photons, 0);
+    fillBins();
+}
+
+/*
+ * Runs flux analysis without storing photons.
+ * Only the bins and the power are computed, the photon buffer is cleared.
+ */
+void FluxAnalysis::runTally(QString nodeURL, QString surfaceSide, ulong nRays, int uDivs, int vDivs)
+{
+    clear();
+    m_surfaceURL = nodeURL;
+    m_surfaceSide = surfaceSide;
+
+    m_binsPhotons.resize(uDivs, vDivs);
+    m_binsPhotons.fill(0);
+    m_photonsMax = 0;
+    m_photonsMaxPos = vec2i(0, 0);
+    m_photonsError = 0;
+
+    InstanceNode* instanceNode = prepare();
+    if (!instanceNode) return;
+
     QVector<InstanceNode*> exportSuraceList;
+    exportSuraceList << instanceNode;
+    bool isFront = m_surfaceSide != "back";
+    PhotonsTally tally(exportSuraceList);
+    tally.setHistogram(instanceNode, isFront, uDivs, vDivs);
+
+    trace(instanceNode, nRays, 0, &tally);
+    m_powerTotal = tally.getHits(instanceNode, isFront)*m_powerPhoton;
+
+    m_binsPhotons = tally.getHistogram();
+    m_box = tally.getHistogramBox();
+    for (int r = 0; r < m_binsPhotons.rows(); ++r) {
+        for (int c = 0; c < m_binsPhotons.cols(); ++c) {
+            if (m_photonsMax < m_binsPhotons(r, c)) {
+                m_photonsMax = m_binsPhotons(r, c);
+                m_photonsMaxPos = vec2i(r, c);
+            }
+        }
+    }
+
+    m_binsFlux = PhotonsTally::findFlux(instanceNode, m_binsPhotons, m_powerPhoton);
+}
+
+/*
+ * Finds the surface, updates the sun and the instance tree for tracing.
+ * Returns 0 if the scene cannot be traced.
+ */
+InstanceNode* FluxAnalysis::prepare()
+{
+    if (!m_sceneKit || !m_instanceLayout || !m_rand) return 0;
+
     QModelIndex nodeIndex = m_sceneModel->indexFromUrl(m_surfaceURL);
-    if (!nodeIndex.isValid()) return;
+    if (!nodeIndex.isValid()) return 0;
     InstanceNode* instanceNode = m_sceneModel->getInstance(nodeIndex);
-    if (!instanceNode) return;
-    exportSuraceList << instanceNode;
+    if (!instanceNode) return 0;
+
+    SunKit* sunKit = static_cast<SunKit*>(m_sceneKit->getPart("world.sun", false));
+    if (!sunKit) return 0;
 
     //UpdateLightSize(); from MainWindow
     sunKit->setBox(m_sceneKit);
@@ -145,59 +191,45 @@ void FluxAnalysis::run(QString nodeURL, QString surfaceSide, ulong nRays, bool p
     //Compute bounding boxes and world to object transforms
     m_instanceLayout->updateTree(Transform::Identity);
 
-    if (!sunKit->findTexture(m_sunDivs.x, m_sunDivs.y, m_instanceLayout)) return;
-
-    QVector<long> raysPerThread;
-    int maximumValueProgressScale = 100;
-
-    ulong t1 = nRays / maximumValueProgressScale;
-    for (int progressCount = 0; progressCount < maximumValueProgressScale; ++progressCount)
-        raysPerThread << t1;
-
-    if (t1*maximumValueProgressScale < nRays)
-        raysPerThread << nRays - t1*maximumValueProgressScale;
-
-    Transform lightToWorld = tgf::makeTransform(sunTransform);
-    instanceSun.setTransform(lightToWorld);
-
-//    QThreadPool::globalInstance()->setMaxThreadCount(1);
-    // Create a progress dialog.
-    QProgressDialog dialog;
-    dialog.setWindowFlag(Qt::WindowContextHelpButtonHint, false);
-    dialog.setLabelText(QString("Progressing using %1 thread(s)...").arg(QThread::idealThreadCount() ) );
+    if (!sunKit->findTexture(m_sunDivs.x, m_sunDivs.y, m_instanceLayout)) return 0;
+    return instanceNode;
+}
 
-    // Create a QFutureWatcher and connect signals and slots.
-    QFutureWatcher<void> watcher;
-//    QObject::connect(&watcher, SIGNAL(finished()), &dialog, SLOT(reset()));
-    QObject::connect(&dialog, SIGNAL(canceled()), &watcher, SLOT(cancel()));
-//    QObject::connect(&watcher, SIGNAL(progressRangeChanged(int,int)), &dialog, SLOT(setRange(int,int)));
-//    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)), &dialog, SLOT(setValue(int)));
+/*
+ * Traces \a nRays into \a photons or \a tally (if not 0) and updates the power of a photon.
+ * Call after prepare.
+ */
+void FluxAnalysis::trace(InstanceNode* surface, ulong nRays, PhotonsBuffer* photons, PhotonsTally* tally)
+{
+    SunKit* sunKit = static_cast<SunKit*>(m_sceneKit->getPart("world.sun", false));
+    SunPosition* sunPosition = (SunPosition*) sunKit->getPart("position", false);
+    SunShape* sunShape = (SunShape*) sunKit->getPart("shape", false);
+    SunAperture* sunAperture = (SunAperture*) sunKit->getPart("aperture", false);
 
-    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)), this, SLOT(processEvents()));
-    QObject::connect(this, SIGNAL(stopSignal()), &watcher, SLOT(cancel()));
+    InstanceNode instanceSun(sunKit);
+    instanceSun.setTransform(tgf::makeTransform(sunKit->m_transform));
 
-    QMutex mutex;
-    QMutex mutexPhotonMap;
-    QFuture<void> photonMap;
+    AirTransmission* air = dynamic_cast<AirTransmission*>(m_sceneKit->getPart("world.air.transmission", false));
     AirTransmission* airTemp = 0;
-    if (air->getTypeId() != AirTransmission::getClassTypeId())
+    if (air && air->getTypeId() != AirTransmission::getClassTypeId())
         airTemp = air;
 
-    photonMap = QtConcurrent::map(raysPerThread, RayTracer(
+    QVector<InstanceNode*> exportSuraceList;
+    exportSuraceList << surface;
+    RayTracer rayTracer(
         m_instanceLayout,
         &instanceSun, sunAperture, sunShape, airTemp,
-        m_rand, &mutex, m_photons, &mutexPhotonMap, exportSuraceList
-    ));
-
-    watcher.setFuture(photonMap);
+        m_rand, photons, exportSuraceList
+    );
+    if (tally) rayTracer.setTally(tally);
 
-    // Display the dialog and start the event loop.
-//    if (!silent) {
-//        dialog.exec();
-//    }
+//    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    QFutureWatcher<void> watcher;
+    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)), this, SLOT(processEvents()));
+    QObject::connect(this, SIGNAL(stopSignal()), &watcher, SLOT(cancel()));
 
-//    dialog.setModal(false);
-//    dialog.show();
+    QVector<RayTracer::Batch> raysPerThread = RayTracer::makeBatches(nRays);
+    watcher.setFuture(QtConcurrent::map(raysPerThread, rayTracer));
     watcher.waitForFinished();
 
     m_tracedRays += nRays;
@@ -205,8 +237,6 @@ void FluxAnalysis::run(QString nodeURL, QString surfaceSide, ulong nRays, bool p
     double irradiance = sunPosition->irradiance.getValue();
     double area = sunAperture->getArea();
     m_powerPhoton = area*irradiance/m_tracedRays;
-
-    fillBins();
 }
 
 /*
@@ -272,6 +302,8 @@ void FluxAnalysis::clear()
     m_tracedRays = 0;
     m_powerPhoton = 0.;
     m_powerTotal = 0.;
+    std::vector<PhotonUV>().swap(m_uvs);
+    m_uvsPhotons = 0;
 }
 
 void FluxAnalysis::processEvents()
@@ -284,6 +316,60 @@ void FluxAnalysis::stop()
     emit stopSignal();
 }
 
+// ranges of items for the threads
+static QVector< QPair<ulong, ulong> > makeRanges(ulong begin, ulong end)
+{
+    QVector< QPair<ulong, ulong> > ranges;
+    if (begin >= end) return ranges;
+    ulong nRanges = 4*std::max(QThread::idealThreadCount(), 1);
+    ulong size = std::max((end - begin + nRanges - 1)/nRanges, ulong(1024));
+    for (ulong n = begin; n < end; n += size)
+        ranges << QPair<ulong, ulong>(n, std::min(n + size, end));
+    return ranges;
+}
+
+/*
+ * Converts the photons added to the buffer since the last call to the uv coordinates of the surface.
+ * Only the active side is kept, the bins are filled from this cache.
+ */
+void FluxAnalysis::updateUVs(InstanceNode* instance, ShapeRT* shape)
+{
+    const std::vector<Photon>& photons = m_photons->getPhotons();
+    if (m_uvsPhotons > photons.size()) {
+        m_uvs.clear();
+        m_uvsPhotons = 0;
+    }
+    if (m_uvsPhotons == photons.size()) return;
+
+    bool isFront = m_surfaceSide != "back";
+    Transform toObject = instance->getTransform().inversed();
+
+    struct Part
+    {
+        QPair<ulong, ulong> range;
+        std::vector<PhotonUV> uvs;
+    };
+    QVector<Part> parts;
+    for (const QPair<ulong, ulong>& range : makeRanges(m_uvsPhotons, photons.size()))
+        parts << Part{range, {}};
+
+    QtConcurrent::blockingMap(parts, [&](Part& part) {
+        part.uvs.reserve(part.range.second - part.range.first);
+        for (ulong n = part.range.first; n < part.range.second; ++n)
+        {
+            const Photon& photon = photons[n];
+            if (photon.isFront != isFront) continue;
+            vec3d p = toObject.transformPoint(photon.pos);
+            vec2d uv = shape->getUV(p);
+            part.uvs.push_back(PhotonUV{float(uv.x), float(uv.y)});
+        }
+    });
+
+    for (const Part& part : parts)
+        m_uvs.insert(m_uvs.end(), part.uvs.begin(), part.uvs.end());
+    m_uvsPhotons = photons.size();
+}
+
 /*
  * Update photon counts
  */
@@ -307,56 +393,67 @@ void FluxAnalysis::fillBins()
     ProfileRT* profile = (ProfileRT*) shapeKit->profileRT.getValue();
     m_box = profile->getBox();
 
-    int activeSideID = m_surfaceSide == "back" ? 0 : 1;
-    Transform toWorld = instance->getTransform();
-    Transform toObject = toWorld.inversed();
+    updateUVs(instance, shape);
 
-    Matrix2D<int> binErrors(m_binsPhotons.rows() - 1, m_binsPhotons.cols() - 1);
-    binErrors.fill(0);
+    // histograms per thread, merged at the end
+    int rows = m_binsPhotons.rows();
+    int cols = m_binsPhotons.cols();
+    int rowsE = std::max(rows - 1, 1);
+    int colsE = std::max(cols - 1, 1);
+    double uMin = m_box.min().x;
+    double vMin = m_box.min().y;
+    double uScale = 1./m_box.size().x;
+    double vScale = 1./m_box.size().y;
 
-    int photonsTotal = 0;
-    for (const Photon& photon : m_photons->getPhotons())
+    struct Part
     {
-        if (photon.isFront != activeSideID) continue;
-        photonsTotal++;
-        vec3d p = toObject.transformPoint(photon.pos);
-        vec2d uv = shape->getUV(p);
-        vec2d q = (uv - m_box.min())/m_box.size();
-
-        int r = floor(q.x*m_binsPhotons.rows());
-        int c = floor(q.y*m_binsPhotons.cols());
-        if (r == m_binsPhotons.rows()) r--;
-        if (c == m_binsPhotons.cols()) c--;
-        int& bin = m_binsPhotons(r, c);
-        bin++;
-        if (m_photonsMax < bin)
+        QPair<ulong, ulong> range;
+        Matrix2D<int> bins;
+        Matrix2D<int> binsE;
+    };
+    QVector<Part> parts;
+    for (const QPair<ulong, ulong>& range : makeRanges(0, m_uvs.size()))
+        parts << Part{range, Matrix2D<int>(), Matrix2D<int>()};
+
+    QtConcurrent::blockingMap(parts, [&](Part& part) {
+        part.bins.resize(rows, cols);
+        part.bins.fill(0);
+        part.binsE.resize(rowsE, colsE);
+        part.binsE.fill(0);
+        for (ulong n = part.range.first; n < part.range.second; ++n)
         {
-            m_photonsMax = bin;
-            m_photonsMaxPos = vec2i(r, c);
+            const PhotonUV& uv = m_uvs[n];
+            vec2d q((uv.u - uMin)*uScale, (uv.v - vMin)*vScale);
+
+            // clamped for the rounding of cache
+            vec2i cell = PhotonsTally::findCell(q, rows, cols);
+            part.bins(cell.x, cell.y)++;
+
+            vec2i cellE = PhotonsTally::findCell(q, rowsE, colsE);
+            part.binsE(cellE.x, cellE.y)++;
         }
+    });
 
-        int rE = floor(q.x*binErrors.rows());
-        int cE = floor(q.y*binErrors.cols());
-        if (rE == binErrors.rows()) rE--;
-        if (cE == binErrors.cols()) cE--;
-        int& binE = binErrors(rE, cE);
-        binE++;
-        if (m_photonsError < binE)
-            m_photonsError = binE;
+    Matrix2D<int> binErrors(rowsE, colsE);
+    binErrors.fill(0);
+    for (const Part& part : parts) {
+        m_binsPhotons += part.bins;
+        binErrors += part.binsE;
     }
 
-    m_powerTotal = photonsTotal*m_powerPhoton;
-
-    // flux
-    vec2i dims(m_binsPhotons.rows(), m_binsPhotons.cols());
-    m_binsFlux.resize(dims.x, dims.y);
-    double uStep = m_box.size().x/dims.x;
-    double vStep = m_box.size().y/dims.y;
-    for (int r = 0; r < dims.x; ++r) {
-        for (int c = 0; c < dims.y; ++c) {
-            double u0 = m_box.min().x + r*uStep;
-            double v0 = m_box.min().y + c*vStep;
-            m_binsFlux(r, c) = m_binsPhotons(r, c)*m_powerPhoton/shape->findArea(u0, v0, u0 + uStep, v0 + vStep, toWorld);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (m_photonsMax < m_binsPhotons(r, c)) {
+                m_photonsMax = m_binsPhotons(r, c);
+                m_photonsMaxPos = vec2i(r, c);
+            }
         }
     }
+    for (int bin : binErrors.data())
+        if (m_photonsError < bin)
+            m_photonsError = bin;
+
+    m_powerTotal = m_uvs.size()*m_powerPhoton;
+
+    m_binsFlux = PhotonsTally::findFlux(instance, m_binsPhotons, m_powerPhoton);
 }
@@ -2,6 +2,8 @@
 
 #include <QObject>
 #include <QString>
+#include <vector>
+
 #include "libraries/math/2D/Matrix2D.h"
 #include "libraries/math/2D/Box2D.h"
 #include "libraries/math/2D/vec2i.h"
@@ -11,6 +13,8 @@ class SceneTreeModel;
 class InstanceNode;
 class Random;
 class PhotonsBuffer;
+class PhotonsTally;
+class ShapeRT;
 
 class FluxAnalysis: public QObject
 {
@@ -22,6 +26,7 @@ public:
 
     QString getShapeType(QString nodeURL);
     void run(QString nodeURL, QString surfaceSide, ulong nRays, bool increasePhotonMap, int uDivs, int vDivs, bool silent = false);
+    void runTally(QString nodeURL, QString surfaceSide, ulong nRays, int uDivs, int vDivs);
     void setBins(int rows, int cols);
     void write(QString fileName, bool withCoords);
     void clear();
@@ -45,7 +50,10 @@ private slots:
     void stop();
 
 private:
+    InstanceNode* prepare();
+    void trace(InstanceNode* surface, ulong nRays, PhotonsBuffer* photons, PhotonsTally* tally);
     void fillBins();
+    void updateUVs(InstanceNode* instance, ShapeRT* shape);
 
     TSceneKit* m_sceneKit;
     SceneTreeModel* m_sceneModel;
@@ -70,4 +78,8 @@ private:
     int m_photonsMax; // maximal number of photons in a cell
     vec2i m_photonsMaxPos; // indices of cell with maximal number of photons
     int m_photonsError; // ?maximal number of photons in a cell for a reduced grid
+
+    struct PhotonUV {float u; float v;};
+    std::vector<PhotonUV> m_uvs; // photons on the active side in surface coordinates, for rebinning
+    ulong m_uvsPhotons; // photons of buffer converted to m_uvs
 };
@@ -1,6 +1,7 @@
 #include "NodeObject.h"
 
 #include <QJSEngine>
+#include <QVector>
 
 #include <Inventor/nodes/SoSeparator.h>
 #include <Inventor/nodes/SoTransform.h>
@@ -13,13 +14,14 @@
 #include "kernel/material/MaterialRT.h"
 #include "kernel/trackers/TrackerArmature.h"
 #include "kernel/trackers/TrackerKit.h"
+#include "kernel/trackers/TrackerTarget.h"
 #include "kernel/sun/SunKit.h"
 #include "kernel/air/AirKit.h"
 #include "kernel/sun/SunShape.h"
 #include "kernel/air/AirTransmission.h"
 
 #include "main/MainWindow.h"
-#include "main/PluginManager.h"
+#include "kernel/node/PluginManager.h"
 #include <QQmlEngine>
 
 MainWindow* NodeObject::s_mainWindow = 0;
@@ -96,6 +98,97 @@ QJSValue NodeObject::createTracker()
     return s_engine->newQObject(ans);
 }
 
+// separators and trackers are copied, shapes and other nodes are shared
+static SoNode* copyTemplate(SoNode* node, TSeparatorKit* parent, QVector<TrackerKit*>& trackers)
+{
+    if (node->getTypeId() == TSeparatorKit::getClassTypeId()) {
+        TSeparatorKit* kitT = (TSeparatorKit*) node;
+        TSeparatorKit* kit = new TSeparatorKit;
+        kit->setName(kitT->getName());
+        kit->setPart("transform", kitT->getPart("transform", true)->copy());
+        if (SoNode* components = kitT->getPart("components", false))
+            kit->setPart("components", components);
+
+        SoGroup* groupT = (SoGroup*) kitT->getPart("group", false);
+        if (groupT) {
+            SoGroup* group = (SoGroup*) kit->getPart("group", true);
+            for (int n = 0; n < groupT->getNumChildren(); ++n)
+                group->addChild(copyTemplate(groupT->getChild(n), kit, trackers));
+        }
+        return kit;
+    }
+    if (node->getTypeId() == TrackerKit::getClassTypeId()) {
+        TrackerKit* kit = (TrackerKit*) node->copy();
+        kit->m_parent = parent;
+        trackers << kit;
+        return kit;
+    }
+    return node;
+}
+
+// array [x, y, z] or string "x y z"
+static bool setVector(SoSFVec3f& field, const QJSValue& value)
+{
+    if (value.isArray()) {
+        field.setValue(value.property(0).toNumber(), value.property(1).toNumber(), value.property(2).toNumber());
+        return true;
+    }
+    if (value.isString())
+        return field.set(value.toString().toLatin1().data());
+    return false;
+}
+
+/*!
+ * Adds a copy of the \a node template for each of the \a positions.
+ * The optional \a aimings set the aiming points of the trackers in the copies,
+ * the optional \a names replace the default names (the template name with the copy number).
+ * Only separators and trackers are copied, shapes are shared, so their meshes are made once.
+ * The copies are built off-line and added with notifications disabled.
+ * Returns the number of copies.
+ */
+int NodeObject::createCopies(QJSValue node, QJSValue positions, QJSValue aimings, QJSValue names)
+{
+    if (m_node->getTypeId() != TSeparatorKit::getClassTypeId()) return 0;
+    NodeObject* nodeObject = qobject_cast<NodeObject*>(node.toQObject());
+    if (!nodeObject || nodeObject->m_node->getTypeId() != TSeparatorKit::getClassTypeId()) return 0;
+    TSeparatorKit* kitT = (TSeparatorKit*) nodeObject->m_node;
+    QString nameT = kitT->getName().getString();
+
+    int nMax = positions.property("length").toInt();
+    QVector<SoNode*> copies;
+    copies.reserve(nMax);
+    for (int n = 0; n < nMax; ++n)
+    {
+        QVector<TrackerKit*> trackers;
+        TSeparatorKit* kit = (TSeparatorKit*) copyTemplate(kitT, 0, trackers);
+        kit->ref();
+        copies << kit;
+
+        TTransform* transform = (TTransform*) kit->getPart("transform", true);
+        setVector(transform->translation, positions.property(n));
+
+        if (aimings.isArray())
+            for (TrackerKit* tracker : trackers) {
+                TrackerTarget* target = (TrackerTarget*) tracker->target.getValue();
+                if (target) setVector(target->aimingPoint, aimings.property(n));
+            }
+
+        QString name = names.isArray() ? names.property(n).toString() : nameT + QString("_%1").arg(n + 1);
+        kit->setName(name.toLatin1().data());
+    }
+
+    TSeparatorKit* parent = (TSeparatorKit*) m_node;
+    SoGroup* group = (SoGroup*) parent->getPart("group", true);
+    SbBool notify = group->enableNotify(FALSE);
+    for (SoNode* copy : copies) {
+        group->addChild(copy);
+        copy->unref();
+    }
+    group->enableNotify(notify);
+    group->touch();
+    return copies.size();
+}
+
 QJSValue NodeObject::getPart(const QString& name)
 {
     if (!m_node->getTypeId().isDerivedFrom(SoBaseKit::getClassTypeId())) return 0;
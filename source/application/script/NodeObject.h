@@ -29,6 +29,7 @@ public slots:
     QJSValue createNode(const QString& name = "");
     QJSValue createShape();
     QJSValue createTracker();
+    int createCopies(QJSValue node, QJSValue positions, QJSValue aimings = QJSValue(), QJSValue names = QJSValue());
 
     QJSValue getPart(const QString& name = "");
     void setPart(const QString& name, QJSValue node);
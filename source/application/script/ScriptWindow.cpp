@@ -18,7 +18,7 @@ Q_DECLARE_METATYPE(QVector<QVariant>)
 #include "DataObject.h"
 #include "main/MainWindow.h"
 #include "kernel/scene/TSceneKit.h"
-#include "main/PluginManager.h"
+#include "kernel/node/PluginManager.h"
 #include "SyntaxHighlighter.h"
 #include "ScriptRayTracer.h"
 #include "tonatiuh_script.h"
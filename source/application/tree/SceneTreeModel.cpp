@@ -109,17 +109,10 @@ InstanceNode* SceneTreeModel::addInstanceNode(InstanceNode* parent, SoNode* node
 
 void SceneTreeModel::generateInstanceTree(InstanceNode* instance)
 {
-    SoNode* node = instance->getNode();
-    if (TSeparatorKit* kit = dynamic_cast<TSeparatorKit*>(node))
+    for (SoNode* node : InstanceNode::getChildNodes(instance->getNode()))
     {
-        SoGroup* group = (SoGroup*) kit->getPart("group", false);
-        if (!group) return;
-        for (int n = 0; n < group->getNumChildren(); ++n)
-        {
-            SoNode* childNode = (SoNode*) group->getChild(n);
-            InstanceNode* childInstance = addInstanceNode(instance, childNode);
-            generateInstanceTree(childInstance);
-        }
+        InstanceNode* childInstance = addInstanceNode(instance, node);
+        generateInstanceTree(childInstance);
     }
 }
 
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = tonatiuh-cli
+DESTDIR = ..
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../config.pri)
+
+QT += concurrent # for multithreading
+
+LIBS += -lTonatiuh-Kernel -lTonatiuh-Libraries
+
+SOURCES += \
+    main.cpp
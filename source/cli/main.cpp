@@ -0,0 +1,352 @@
+#include <limits>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QtConcurrentMap>
+
+#include <Inventor/SoDB.h>
+#include <Inventor/sensors/SoSensorManager.h>
+
+#include "kernel/air/AirTransmission.h"
+#include "kernel/air/AirVacuum.h"
+#include "kernel/node/PluginManager.h"
+#include "kernel/node/TonatiuhFunctions.h"
+#include "kernel/photons/PhotonsAbstract.h"
+#include "kernel/photons/PhotonsBuffer.h"
+#include "kernel/photons/PhotonsSettings.h"
+#include "kernel/photons/PhotonsTally.h"
+#include "kernel/random/Random.h"
+#include "kernel/run/InstanceNode.h"
+#include "kernel/run/RayTracer.h"
+#include "kernel/run/ShadingAnalysis.h"
+#include "kernel/run/TraceSeries.h"
+#include "kernel/scene/TSceneKit.h"
+#include "kernel/scene/TSeparatorKit.h"
+#include "kernel/scene/TShapeKit.h"
+#include "kernel/sun/SunAperture.h"
+#include "kernel/sun/SunKit.h"
+#include "kernel/sun/SunPosition.h"
+#include "libraries/math/2D/Matrix2D.h"
+
+QTextStream cout(stdout);
+QTextStream cerr(stderr);
+
+/*!
+   Command line ray tracer.
+   Reads a scene, traces the rays and writes the photons and the flux map
+   without QApplication, SoQt or a window, so it runs on machines without a display.
+ */
+
+InstanceNode* findInstance(InstanceNode* instance, const QString& url)
+{
+    if (instance->getURL() == url) return instance;
+    for (InstanceNode* child : instance->children)
+        if (InstanceNode* ans = findInstance(child, url))
+            return ans;
+    return 0;
+}
+
+bool parseSize(const QString& text, int& a, int& b)
+{
+    QStringList list = text.split(QRegularExpression("[x,]"));
+    if (list.size() != 2) return false;
+    bool okA, okB;
+    a = list[0].toInt(&okA);
+    b = list[1].toInt(&okB);
+    return okA && okB && a > 0 && b > 0;
+}
+
+/*!
+ * Writes the flux (W/m2) on \a instance as a matrix of \a rows x \a cols cells in the uv-space of its shape.
+ * Returns the power on the surface.
+ */
+double writeFlux(const QString& fileName, InstanceNode* instance, bool isFront,
+                 const std::vector<Photon>& photons, double powerPhoton, int rows, int cols)
+{
+    PhotonsTally tally(QVector<InstanceNode*>() << instance);
+    tally.setHistogram(instance, isFront, rows, cols);
+    tally.add(photons);
+    double power = tally.getHits(instance, isFront)*powerPhoton;
+    Matrix2D<double> flux = PhotonsTally::findFlux(instance, tally.getHistogram(), powerPhoton);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        cerr << QString("Cannot open file %1.").arg(fileName) << Qt::endl;
+        return power;
+    }
+    QTextStream out(&file);
+
+    for (int r = 0; r < flux.rows(); ++r) {
+        for (int c = 0; c < flux.cols(); ++c)
+            out << flux(r, c) << "\t";
+        out << "\n";
+    }
+    return power;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("tonatiuh-cli");
+    app.setApplicationVersion(APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tonatiuh ray tracer without graphical interface");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("scene", "Scene file (tnh, tnhpp)");
+
+    QCommandLineOption optionRays({"n", "rays"}, "Number of rays", "number", "1000000");
+    parser.addOption(optionRays);
+    QCommandLineOption optionGrid("grid", "Divisions of sun aperture", "width,height", "200,200");
+    parser.addOption(optionGrid);
+    QCommandLineOption optionSurface({"s", "surface"}, "Surface to export, can be repeated (all by default)", "url");
+    parser.addOption(optionSurface);
+    QCommandLineOption optionPhotons({"o", "photons"}, "Photon map file (*.tph for compact format)", "file");
+    parser.addOption(optionPhotons);
+    QCommandLineOption optionFlux({"f", "flux"}, "Flux map file for the first surface", "file");
+    parser.addOption(optionFlux);
+    QCommandLineOption optionSide("side", "Side of surface for flux map (front, back)", "side", "front");
+    parser.addOption(optionSide);
+    QCommandLineOption optionBins("bins", "Cells of flux map", "u,v", "20,20");
+    parser.addOption(optionBins);
+    QCommandLineOption optionSuns("suns", "Trace each sun position of file (azimuth elevation weight) and print the power on surfaces", "file");
+    parser.addOption(optionSuns);
+    QCommandLineOption optionShading("shading", "With --suns, print the shaded fraction of surfaces from a grid of points on each", "u,v");
+    parser.addOption(optionShading);
+    QCommandLineOption optionRandom("random", "Random generator", "name");
+    parser.addOption(optionRandom);
+    QCommandLineOption optionSeed("seed", "Seed of random generator", "number");
+    parser.addOption(optionSeed);
+    QCommandLineOption optionPlugins("plugins", "Directory with plugins", "dir",
+        QDir(app.applicationDirPath()).absoluteFilePath("plugins"));
+    parser.addOption(optionPlugins);
+
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.size() != 1) parser.showHelp(1);
+    QString fileName = args[0];
+
+    ulong nRays = parser.value(optionRays).toULong();
+    int gridWidth, gridHeight;
+    int binsU, binsV;
+    int pointsU = 0, pointsV = 0;
+    if (nRays == 0 ||
+        !parseSize(parser.value(optionGrid), gridWidth, gridHeight) ||
+        !parseSize(parser.value(optionBins), binsU, binsV) ||
+        (parser.isSet(optionShading) && !parseSize(parser.value(optionShading), pointsU, pointsV)))
+    {
+        cerr << "Invalid arguments." << Qt::endl;
+        return 1;
+    }
+    QString fluxFile = parser.value(optionFlux);
+    QStringList surfaceURLs = parser.values(optionSurface);
+    if (!fluxFile.isEmpty() && surfaceURLs.isEmpty())
+    {
+        cerr << "Flux map requires a surface." << Qt::endl;
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // scene
+    SoDB::init();
+    PluginManager pluginManager;
+    pluginManager.load(QDir(parser.value(optionPlugins)));
+
+    QStringList searchPaths;
+    searchPaths << QFileInfo(fileName).absolutePath() << QDir::currentPath();
+    QDir::setSearchPaths("project", searchPaths);
+
+    QString message;
+    TSceneKit* sceneKit = TSceneKit::readFile(fileName, message);
+    if (!sceneKit)
+    {
+        cerr << message << Qt::endl;
+        return 1;
+    }
+    sceneKit->ref();
+    // nodes with delayed sensors update their cached parameters here
+    SoDB::getSensorManager()->processDelayQueue(FALSE);
+    sceneKit->updateParents();
+    sceneKit->updateTrackers();
+
+    InstanceNode instanceScene(sceneKit);
+    InstanceNode* instanceLayout = new InstanceNode(sceneKit->getLayout());
+    instanceScene.addChild(instanceLayout);
+    instanceLayout->generateTree();
+
+    QVector<InstanceNode*> exportSurfaceList;
+    for (QString url : surfaceURLs)
+    {
+        InstanceNode* instance = findInstance(&instanceScene, url);
+        if (!instance || !dynamic_cast<TShapeKit*>(instance->getNode()))
+        {
+            cerr << QString("Surface %1 not found.").arg(url) << Qt::endl;
+            return 1;
+        }
+        exportSurfaceList << instance;
+    }
+
+    SunKit* sunKit = (SunKit*) sceneKit->getPart("world.sun", false);
+    SunPosition* sunPosition = (SunPosition*) sunKit->getPart("position", false);
+    SunShape* sunShape = (SunShape*) sunKit->getPart("shape", false);
+    SunAperture* sunAperture = (SunAperture*) sunKit->getPart("aperture", false);
+    sunKit->setBox(sceneKit);
+
+    instanceLayout->updateTree(Transform::Identity);
+    if (!sunKit->findTexture(gridWidth, gridHeight, instanceLayout))
+    {
+        cerr << "There are no surfaces defined for ray tracing." << Qt::endl;
+        return 1;
+    }
+
+    InstanceNode instanceSun(sunKit);
+    instanceSun.setTransform(tgf::makeTransform(sunKit->m_transform));
+
+    AirTransmission* air = (AirTransmission*) sceneKit->getPart("world.air.transmission", false);
+    if (air && air->getTypeId() == AirVacuum::getClassTypeId()) air = 0;
+
+    // random
+    QVector<RandomFactory*> randomFactories = pluginManager.getRandomFactories();
+    RandomFactory* randomFactory = randomFactories.isEmpty() ? 0 : randomFactories[0];
+    if (parser.isSet(optionRandom))
+        randomFactory = pluginManager.getRandomMap().value(parser.value(optionRandom), 0);
+    if (!randomFactory)
+    {
+        cerr << "Random generator not found." << Qt::endl;
+        return 1;
+    }
+    Random* rand;
+    if (parser.isSet(optionSeed))
+    {
+        rand = randomFactory->create(0, parser.value(optionSeed).toULong());
+        // the streams of the workers must be seeded from rand too
+        Random* stream = rand->createStream(0);
+        if (!stream)
+        {
+            cerr << QString("Random generator %1 does not support seeds.").arg(randomFactory->name()) << Qt::endl;
+            delete rand;
+            return 1;
+        }
+        delete stream;
+    }
+    else
+        rand = randomFactory->create(0);
+
+    // series of sun positions
+    if (parser.isSet(optionSuns))
+    {
+        QVector<TraceSeries::Sample> samples = TraceSeries::readSamples(parser.value(optionSuns), message);
+        if (samples.isEmpty())
+        {
+            cerr << message << Qt::endl;
+            return 1;
+        }
+
+        if (parser.isSet(optionShading))
+        {
+            ShadingAnalysis shading(sceneKit, instanceLayout, exportSurfaceList);
+            shading.setGrid(pointsU, pointsV);
+            if (!shading.run(samples))
+            {
+                cerr << "There are no surfaces defined for ray tracing." << Qt::endl;
+                return 1;
+            }
+            shading.write(cout);
+            cout << QString("Shading found: %1 s").arg(timer.elapsed()/1000., 0, 'f', 3) << Qt::endl;
+
+            delete rand;
+            sceneKit->unref();
+            return 0;
+        }
+
+        TraceSeries series(sceneKit, instanceLayout, exportSurfaceList);
+        series.setRays(nRays);
+        series.setGrid(gridWidth, gridHeight);
+        series.setRandom(rand);
+        if (!series.run(samples))
+        {
+            cerr << "There are no surfaces defined for ray tracing." << Qt::endl;
+            return 1;
+        }
+        series.write(cout);
+        cout << QString("Rays traced: %1 s").arg(timer.elapsed()/1000., 0, 'f', 3) << Qt::endl;
+
+        delete rand;
+        sceneKit->unref();
+        return 0;
+    }
+
+    // photons
+    // the flux map needs all photons in memory
+    ulong bufferSize = fluxFile.isEmpty() ? 1'000'000 : std::numeric_limits<int>::max();
+    PhotonsBuffer photonsBuffer(bufferSize, fluxFile.isEmpty() ? bufferSize : 0);
+
+    PhotonsSettings settings;
+    settings.saveCoordinates = true;
+    settings.saveCoordinatesGlobal = true;
+    settings.saveSurfaceID = true;
+    settings.saveSurfaceSide = true;
+    settings.savePhotonsID = true;
+    settings.surfaces = surfaceURLs;
+
+    QString photonsFile = parser.value(optionPhotons);
+    if (!photonsFile.isEmpty())
+    {
+        PhotonsFactory* f = pluginManager.getExportMap().value("File", 0);
+        if (!f)
+        {
+            cerr << "Photon export plugin not found." << Qt::endl;
+            return 1;
+        }
+        QFileInfo info(photonsFile);
+        settings.name = f->name();
+        settings.parameters["ExportDirectory"] = info.absolutePath();
+        settings.parameters["ExportFile"] = info.completeBaseName();
+        settings.parameters["FileSize"] = "-1";
+        settings.parameters["Format"] = info.suffix() == "tph" ? "Compact" : "Double";
+
+        PhotonsAbstract* exporter = f->create(0);
+        exporter->setPhotonSettings(&settings);
+        if (!photonsBuffer.setExporter(exporter)) return 1;
+    }
+
+    // tracing
+    cout << QString("Scene loaded: %1 s").arg(timer.elapsed()/1000., 0, 'f', 3) << Qt::endl;
+
+    QVector<RayTracer::Batch> batches = RayTracer::makeBatches(nRays);
+    QtConcurrent::blockingMap(batches, RayTracer(
+        instanceLayout,
+        &instanceSun, sunAperture, sunShape, air,
+        rand, &photonsBuffer, exportSurfaceList
+    ));
+
+    double area = sunAperture->getArea();
+    double irradiance = sunPosition->irradiance.getValue();
+    double powerPhoton = area*irradiance/nRays;
+
+    cout << QString("Rays traced: %1 s").arg(timer.elapsed()/1000., 0, 'f', 3) << Qt::endl;
+    cout << "Power per photon (W): " << powerPhoton << Qt::endl;
+
+    if (!fluxFile.isEmpty())
+    {
+        bool isFront = parser.value(optionSide) != "back";
+        double power = writeFlux(fluxFile, exportSurfaceList[0], isFront, photonsBuffer.getPhotons(), powerPhoton, binsU, binsV);
+        cout << "Power on surface (W): " << power << Qt::endl;
+    }
+
+    photonsBuffer.endExport(powerPhoton);
+    delete photonsBuffer.getExporter();
+    delete rand;
+    sceneKit->unref();
+    return 0;
+}
@@ -5,6 +5,8 @@ DEFINES += TONATIUH_KERNEL_EXPORT
 
 include(../config.pri)
 
+QT += concurrent # for multithreading
+
 LIBS += -lTonatiuh-Libraries
 
 win32 {
@@ -25,6 +27,7 @@ HEADERS += \
     material/MaterialRough.h \
     material/MaterialTransparent.h \
     material/MaterialVirtual.h \
+    node/PluginManager.h \
     node/TFactory.h \
     node/TNode.h \
     node/TonatiuhFunctions.h \
@@ -32,7 +35,9 @@ HEADERS += \
     photons/Photon.h \
     photons/PhotonsAbstract.h \
     photons/PhotonsBuffer.h \
+    photons/PhotonsCompact.h \
     photons/PhotonsSettings.h \
+    photons/PhotonsTally.h \
     photons/PhotonsWidget.h \
     profiles/ProfileBox.h \
     profiles/ProfileCircular.h \
@@ -45,7 +50,11 @@ HEADERS += \
     random/RandomParallel.h \
     random/RandomSTL.h \
     run/InstanceNode.h \
+    run/InstanceSet.h \
     run/RayTracer.h \
+    run/SceneBVH.h \
+    run/ShadingAnalysis.h \
+    run/TraceSeries.h \
     scene/GridNode.h \
     scene/LocationNode.h \
     scene/MaterialGL.h \
@@ -63,6 +72,7 @@ HEADERS += \
     scene/TerrainKit.h \
     scene/WorldKit.h \
     shape/DifferentialGeometry.h \
+    shape/PolygonMeshCache.h \
     shape/ShapeCone.h \
     shape/ShapeCube.h \
     shape/ShapeCylinder.h \
@@ -70,6 +80,7 @@ HEADERS += \
     shape/ShapePlanar.h \
     shape/ShapeRT.h \
     shape/ShapeSphere.h \
+    shape/TriangleMesh.h \
     sun/SunAperture.h \
     sun/SunKit.h \
     sun/SunPosition.h \
@@ -80,6 +91,7 @@ HEADERS += \
     trackers/TrackerArmature1A.h \
     trackers/TrackerArmature2A.h \
     trackers/TrackerArmature2AwD.h \
+    trackers/TrackerBatch.h \
     trackers/TrackerKit.h \
     trackers/TrackerSolver.h \
     trackers/TrackerSolver1A.h \
@@ -99,12 +111,15 @@ SOURCES += \
     material/MaterialRough.cpp \
     material/MaterialTransparent.cpp \
     material/MaterialVirtual.cpp \
+    node/PluginManager.cpp \
     node/TNode.cpp \
     node/TonatiuhFunctions.cpp \
     photons/Photon.cpp \
     photons/PhotonsAbstract.cpp \
     photons/PhotonsBuffer.cpp \
+    photons/PhotonsCompact.cpp \
     photons/PhotonsSettings.cpp \
+    photons/PhotonsTally.cpp \
     photons/PhotonsWidget.cpp \
     profiles/ProfileBox.cpp \
     profiles/ProfileCircular.cpp \
@@ -116,7 +131,11 @@ SOURCES += \
     random/RandomParallel.cpp \
     random/RandomSTL.cpp \
     run/InstanceNode.cpp \
+    run/InstanceSet.cpp \
     run/RayTracer.cpp \
+    run/SceneBVH.cpp \
+    run/ShadingAnalysis.cpp \
+    run/TraceSeries.cpp \
     scene/GridNode.cpp \
     scene/LocationNode.cpp \
     scene/MaterialGL.cpp \
@@ -134,6 +153,7 @@ SOURCES += \
     scene/TerrainKit.cpp \
     scene/WorldKit.cpp \
     shape/DifferentialGeometry.cpp \
+    shape/PolygonMeshCache.cpp \
     shape/ShapeCone.cpp \
     shape/ShapeCube.cpp \
     shape/ShapeCylinder.cpp \
@@ -141,6 +161,7 @@ SOURCES += \
     shape/ShapePlanar.cpp \
     shape/ShapeRT.cpp \
     shape/ShapeSphere.cpp \
+    shape/TriangleMesh.cpp \
     sun/SunAperture.cpp \
     sun/SunKit.cpp \
     sun/SunPosition.cpp \
@@ -151,6 +172,7 @@ SOURCES += \
     trackers/TrackerArmature1A.cpp \
     trackers/TrackerArmature2A.cpp \
     trackers/TrackerArmature2AwD.cpp \
+    trackers/TrackerBatch.cpp \
     trackers/TrackerKit.cpp \
     trackers/TrackerSolver.cpp \
     trackers/TrackerSolver1A.cpp \
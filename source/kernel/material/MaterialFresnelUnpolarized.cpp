@@ -25,6 +25,8 @@ MaterialFresnelUnpolarized::MaterialFresnelUnpolarized()
     SO_NODE_ADD_FIELD(distribution, (Gaussian) );
 
     SO_NODE_ADD_FIELD(slope, (0.002) ); // in radians
+
+    attachSensor();
 }
 
 bool MaterialFresnelUnpolarized::OutputRay(const Ray& rayIn, const DifferentialGeometry& dg, Random& rand, Ray& rayOut) const
@@ -33,18 +35,18 @@ bool MaterialFresnelUnpolarized::OutputRay(const Ray& rayIn, const DifferentialG
 
     // surface roughness
     vec3d normal;
-    double sigma = slope.getValue();
+    double sigma = m_slope;
     if (sigma > 0.) {
-        if (distribution.getValue() == Distribution::pillbox)
+        if (m_distribution == Distribution::pillbox)
         {
             double phi = gcf::TwoPi*rand.RandomDouble();
-            double sinTheta = sin(sigma)*sqrt(rand.RandomDouble());
+            double sinTheta = m_sinSlope*sqrt(rand.RandomDouble());
             double cosTheta = sqrt(1. - sinTheta*sinTheta);
             normal.x = sinTheta*cos(phi);
             normal.y = sinTheta*sin(phi);
             normal.z = cosTheta;
         }
-        else //if (distribution.getValue() == Distribution::Gaussian)
+        else //if (m_distribution == Distribution::Gaussian)
         {
             // https://en.wikipedia.org/wiki/Marsaglia_polar_method
             double u, v, s;
@@ -70,8 +72,8 @@ bool MaterialFresnelUnpolarized::OutputRay(const Ray& rayIn, const DifferentialG
     // select sides according to incident ray
     const vec3d& dI = rayIn.direction();
     double dIn = dot(dI, normal);
-    double nI = nFront.getValue();
-    double nT = nBack.getValue();
+    double nI = m_nFront;
+    double nT = m_nBack;
     if (dIn > 0.) {
         std::swap(nI, nT);
         normal = -normal;
@@ -101,3 +103,12 @@ bool MaterialFresnelUnpolarized::OutputRay(const Ray& rayIn, const DifferentialG
     rayOut.setDirection(dO);
     return true;
 }
+
+void MaterialFresnelUnpolarized::updateCache()
+{
+    m_nFront = nFront.getValue();
+    m_nBack = nBack.getValue();
+    m_distribution = distribution.getValue();
+    m_slope = slope.getValue();
+    m_sinSlope = sin(m_slope);
+}
@@ -27,6 +27,12 @@ public:
     NAME_ICON_FUNCTIONS("Fresnel (unpolarized)", ":/material/MaterialFresnel.png")
 
 protected:
-    ~MaterialFresnelUnpolarized() {}
+    double m_nFront;
+    double m_nBack;
+    int m_distribution;
+    double m_slope;
+    double m_sinSlope;
+
+    void updateCache();
 };
 
@@ -25,13 +25,15 @@ MaterialRough::MaterialRough()
     SO_NODE_ADD_FIELD(distribution, (Beckmann) );
     SO_NODE_ADD_FIELD(roughness, (0.) );
 
+
+    attachSensor();
 }
 
 
 // http://www.pbr-book.org/3ed-2018/Light_Transport_I_Surface_Reflection/Sampling_Reflection_Functions.html
 bool MaterialRough::OutputRay(const Ray& rayIn, const DifferentialGeometry& dg, Random& rand, Ray& rayOut) const
 {
-    if (rand.RandomDouble() <= diffuse.getValue())
+    if (rand.RandomDouble() <= m_diffuse)
     {
         rayOut.origin = dg.point;
 
@@ -55,20 +57,20 @@ bool MaterialRough::OutputRay(const Ray& rayIn, const DifferentialGeometry& dg,
         rayOut.setDirection(dDiff);
         return true;
     }
-    else if (rand.RandomDouble() <= diffuse.getValue() + specular.getValue())
+    else if (rand.RandomDouble() <= m_diffuse + m_specular)
     {
         rayOut.origin = dg.point;
 
         vec3d normal;
-        double alpha = roughness.getValue();
+        double alpha = m_roughness;
         if (alpha > 0.) {
             double phi = gcf::TwoPi*rand.RandomDouble();
             double tan2Theta = 0.;
-            if (distribution.getValue() == Distribution::Beckmann)
+            if (m_distribution == Distribution::Beckmann)
             {
                 tan2Theta = -gcf::pow2(alpha)*std::log(rand.RandomDouble());
             }
-            else if (distribution.getValue() == Distribution::Trowbridge)
+            else if (m_distribution == Distribution::Trowbridge)
             {
                 double u = rand.RandomDouble();
                 tan2Theta = gcf::pow2(alpha)*u/(1. - u);
@@ -98,3 +100,11 @@ bool MaterialRough::OutputRay(const Ray& rayIn, const DifferentialGeometry& dg,
 
     return false;
 }
+
+void MaterialRough::updateCache()
+{
+    m_diffuse = diffuse.getValue();
+    m_specular = specular.getValue();
+    m_distribution = distribution.getValue();
+    m_roughness = roughness.getValue();
+}
@@ -26,6 +26,11 @@ public:
     NAME_ICON_FUNCTIONS("Rough", ":/material/MaterialRough.png")
 
 protected:
-    ~MaterialRough() {}
+    double m_diffuse;
+    double m_specular;
+    int m_distribution;
+    double m_roughness;
+
+    void updateCache();
 };
 
@@ -42,9 +42,6 @@
 #include "libraries/Coin3D/UserMField.h"
 #include "libraries/Coin3D/UserSField.h"
 #include "libraries/math/gcf.h"
-#include "view/SkyNode3D.h"
-#include "view/OverlayNode.h"
-#include "view/SeparatorStyle.h"
 
 
 PluginManager::PluginManager()
@@ -55,9 +52,6 @@ PluginManager::PluginManager()
     TNode::initClass();
 
     TSceneKit::initClass();
-    SkyNode3D::initClass();
-    OverlayNode::initClass();
-    SeparatorStyle::initClass();
 }
 
 /*!
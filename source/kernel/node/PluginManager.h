@@ -1,5 +1,7 @@
 #pragma once
 
+#include "kernel/TonatiuhKernel.h"
+
 #include <QVector>
 #include <QMap>
 
@@ -22,7 +24,7 @@ class SoNode;
  * \brief PluginManager class manages plugin loading.
  * PluginManager is used to load plugins, manage the list of loaded plugins.
  */
-class PluginManager
+class TONATIUH_KERNEL PluginManager
 {
 
 public:
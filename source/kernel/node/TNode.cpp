@@ -1,5 +1,7 @@
 #include "TNode.h"
 
+#include <Inventor/sensors/SoNodeSensor.h>
+
 SO_NODE_ABSTRACT_SOURCE(TNode)
 
 
@@ -7,3 +9,28 @@ void TNode::initClass()
 {
     SO_NODE_INIT_ABSTRACT_CLASS(TNode, SoNode, "Node");
 }
+
+TNode::~TNode()
+{
+    delete m_cacheSensor;
+}
+
+/*!
+ * Calls updateCache now and immediately after each change of the fields,
+ * so the tracing threads never read Coin fields.
+ */
+void TNode::attachSensor()
+{
+    if (!m_cacheSensor) {
+        m_cacheSensor = new SoNodeSensor(onCacheSensor, this);
+        m_cacheSensor->setPriority(0);
+        m_cacheSensor->attach(this);
+    }
+    updateCache();
+}
+
+void TNode::onCacheSensor(void* data, SoSensor*)
+{
+    TNode* node = (TNode*) data;
+    node->updateCache();
+}
@@ -26,6 +26,14 @@ public:
     NAME_ICON_FUNCTIONS("X", ":/X.png")
 
 protected:
-    TNode() {}
-    ~TNode() {}
+    TNode(): m_cacheSensor(0) {}
+    ~TNode();
+
+    // copies the fields read during ray tracing to plain members
+    virtual void updateCache() {}
+    void attachSensor(); // at the end of the constructor
+
+private:
+    SoNodeSensor* m_cacheSensor;
+    static void onCacheSensor(void* data, SoSensor*);
 };
@@ -15,23 +15,23 @@
 
 SbMatrix tgf::makeSbMatrix(const Transform& transform)
 {
-    std::shared_ptr<Matrix4x4> transformMatrix = transform.getMatrix()->transposed();
-    float m00 = float(transformMatrix->m[0][0]);
-    float m01 = float(transformMatrix->m[0][1]);
-    float m02 = float(transformMatrix->m[0][2]);
-    float m03 = float(transformMatrix->m[0][3]);
-    float m10 = float(transformMatrix->m[1][0]);
-    float m11 = float(transformMatrix->m[1][1]);
-    float m12 = float(transformMatrix->m[1][2]);
-    float m13 = float(transformMatrix->m[1][3]);
-    float m20 = float(transformMatrix->m[2][0]);
-    float m21 = float(transformMatrix->m[2][1]);
-    float m22 = float(transformMatrix->m[2][2]);
-    float m23 = float(transformMatrix->m[2][3]);
-    float m30 = float(transformMatrix->m[3][0]);
-    float m31 = float(transformMatrix->m[3][1]);
-    float m32 = float(transformMatrix->m[3][2]);
-    float m33 = float(transformMatrix->m[3][3]);
+    Matrix4x4 transformMatrix = transform.getMatrix();
+    float m00 = float(transformMatrix.m[0][0]);
+    float m01 = float(transformMatrix.m[1][0]);
+    float m02 = float(transformMatrix.m[2][0]);
+    float m03 = float(transformMatrix.m[3][0]);
+    float m10 = float(transformMatrix.m[0][1]);
+    float m11 = float(transformMatrix.m[1][1]);
+    float m12 = float(transformMatrix.m[2][1]);
+    float m13 = float(transformMatrix.m[3][1]);
+    float m20 = float(transformMatrix.m[0][2]);
+    float m21 = float(transformMatrix.m[1][2]);
+    float m22 = float(transformMatrix.m[2][2]);
+    float m23 = float(transformMatrix.m[3][2]);
+    float m30 = float(transformMatrix.m[0][3]);
+    float m31 = float(transformMatrix.m[1][3]);
+    float m32 = float(transformMatrix.m[2][3]);
+    float m33 = float(transformMatrix.m[3][3]);
 
     SbVec3f axis1(m00, m10, m20);
     SbVec3f axis2(m01, m11, m21);
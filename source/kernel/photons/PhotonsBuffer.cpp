@@ -1,28 +1,59 @@
 #include "PhotonsBuffer.h"
 #include "PhotonsAbstract.h"
 
-PhotonsBuffer::PhotonsBuffer(ulong size, ulong sizeReserve):
+#include <algorithm>
+
+PhotonsBuffer::PhotonsBuffer(ulong size, ulong sizeReserve, int queueSize):
     m_photonsMax(size),
-    m_exporter(0)
+    m_exporter(0),
+    m_shardsMax(queueSize),
+    m_isWriting(false),
+    m_isStopped(false)
 {
     if (sizeReserve > 0)
         m_photons.reserve(sizeReserve);
+
+    if (m_shardsMax <= 0)
+        m_shardsMax = 2*std::max(int(std::thread::hardware_concurrency()), 1);
+
+    m_writer = std::thread(&PhotonsBuffer::runWriter, this);
 }
 
-void PhotonsBuffer::addPhotons(const std::vector<Photon>& photons)
+PhotonsBuffer::~PhotonsBuffer()
 {
-    uint nMax = photons.size();
-    if (m_photons.size() > 0 && m_photons.size() + nMax > m_photonsMax)
     {
-        if (m_exporter) m_exporter->savePhotons(m_photons);
-        m_photons.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopped = true;
     }
+    m_conditionShards.notify_all();
+    m_writer.join();
+}
 
-    m_photons.insert(m_photons.end(), photons.begin(), photons.end());
+/*!
+ * Moves \a photons into the queue of the writer, \a photons is left empty.
+ * Waits only if the queue is full.
+ */
+void PhotonsBuffer::addPhotons(std::vector<Photon>& photons)
+{
+    if (photons.empty()) return;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_conditionSpace.wait(lock, [this] {return int(m_shards.size()) < m_shardsMax;});
+        m_shards.push_back(std::vector<Photon>());
+        m_shards.back().swap(photons);
+    }
+    m_conditionShards.notify_one();
+}
+
+const std::vector<Photon>& PhotonsBuffer::getPhotons() const
+{
+    flush();
+    return m_photons;
 }
 
 void PhotonsBuffer::endExport(double p)
 {
+    flush();
     if (m_photons.size() > 0)
     {
         if (m_exporter) m_exporter->savePhotons(m_photons);
@@ -38,6 +69,55 @@ void PhotonsBuffer::endExport(double p)
 bool PhotonsBuffer::setExporter(PhotonsAbstract* exporter)
 {
     if (!exporter) return false;
+    flush();
     m_exporter = exporter;
     return m_exporter->startExport();
 }
+
+/*!
+ * Waits until the writer has merged all queued shards.
+ */
+void PhotonsBuffer::flush() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_conditionSpace.wait(lock, [this] {return m_shards.empty() && !m_isWriting;});
+}
+
+void PhotonsBuffer::runWriter()
+{
+    while (true)
+    {
+        std::vector<Photon> shard;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_conditionShards.wait(lock, [this] {return !m_shards.empty() || m_isStopped;});
+            if (m_shards.empty()) return;
+            shard.swap(m_shards.front());
+            m_shards.pop_front();
+            m_isWriting = true;
+        }
+        m_conditionSpace.notify_all();
+
+        writeShard(shard);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isWriting = false;
+        }
+        m_conditionSpace.notify_all();
+    }
+}
+
+void PhotonsBuffer::writeShard(std::vector<Photon>& photons)
+{
+    if (m_photons.size() > 0 && m_photons.size() + photons.size() > m_photonsMax)
+    {
+        if (m_exporter) m_exporter->savePhotons(m_photons);
+        m_photons.clear();
+    }
+
+    if (m_photons.empty() && photons.size() >= m_photons.capacity())
+        m_photons.swap(photons);
+    else
+        m_photons.insert(m_photons.end(), photons.begin(), photons.end());
+}
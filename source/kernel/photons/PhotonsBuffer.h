@@ -2,24 +2,49 @@
 
 #include "Photon.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 class PhotonsAbstract;
 
 
+//! PhotonsBuffer collects the photons of the ray tracing threads.
+/*!
+ * Each thread hands over its own shard of photons to a bounded queue.
+ * A writer thread merges the shards and passes them to the exporter,
+ * so the tracing threads neither wait for each other nor for the exporter.
+ */
 class TONATIUH_KERNEL PhotonsBuffer
 {
 public:
-    PhotonsBuffer(ulong size, ulong sizeReserve = 0);
+    PhotonsBuffer(ulong size, ulong sizeReserve = 0, int queueSize = 0);
+    ~PhotonsBuffer();
 
-    void addPhotons(const std::vector<Photon>& photons);
-    const std::vector<Photon>& getPhotons() const {return m_photons;} // for flux and screen
+    void addPhotons(std::vector<Photon>& photons); // takes the content of photons
+    const std::vector<Photon>& getPhotons() const; // for flux and screen
     void endExport(double p);
 
     bool setExporter(PhotonsAbstract* exporter);
     PhotonsAbstract* getExporter() const {return m_exporter;}
 
 private:
+    void flush() const;
+    void runWriter();
+    void writeShard(std::vector<Photon>& photons);
+
     std::vector<Photon> m_photons; // buffer, std is faster than QVector
     ulong m_photonsMax;
 
     PhotonsAbstract* m_exporter;
+
+    std::deque< std::vector<Photon> > m_shards; // queue for writer
+    int m_shardsMax;
+    bool m_isWriting;
+    bool m_isStopped;
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_conditionShards; // shard added or stop
+    mutable std::condition_variable m_conditionSpace; // shard removed or written
+    std::thread m_writer;
 };
@@ -0,0 +1,92 @@
+#include "PhotonsCompact.h"
+
+#include <cstring>
+
+
+PhotonsCompactHeader::PhotonsCompactHeader():
+    version(Version),
+    recordSize(sizeof(PhotonsCompactRecord)),
+    flags(0),
+    count(0),
+    power(0.)
+{
+    std::memcpy(magic, "TPHC", 4);
+}
+
+bool PhotonsCompactHeader::isValid() const
+{
+    return std::memcmp(magic, "TPHC", 4) == 0 &&
+        version == Version &&
+        recordSize == sizeof(PhotonsCompactRecord);
+}
+
+
+
+PhotonsCompactReader::PhotonsCompactReader():
+    m_data(0),
+    m_records(0)
+{
+
+}
+
+PhotonsCompactReader::~PhotonsCompactReader()
+{
+    close();
+}
+
+bool PhotonsCompactReader::open(const QString& fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    qint64 fileSize = m_file.size();
+    if (fileSize < qint64(sizeof(PhotonsCompactHeader))) {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, fileSize);
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    PhotonsCompactHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    header.version = qFromLittleEndian(header.version);
+    header.recordSize = qFromLittleEndian(header.recordSize);
+    header.flags = qFromLittleEndian(header.flags);
+    header.count = qFromLittleEndian(header.count);
+    header.power = qFromLittleEndian(header.power);
+
+    quint64 countMax = (fileSize - sizeof(PhotonsCompactHeader))/sizeof(PhotonsCompactRecord);
+    if (!header.isValid() || header.count > countMax) {
+        close();
+        return false;
+    }
+
+    m_header = header;
+    m_records = (const PhotonsCompactRecord*) (m_data + sizeof(PhotonsCompactHeader));
+    return true;
+}
+
+void PhotonsCompactReader::close()
+{
+    if (m_data) m_file.unmap(m_data);
+    m_data = 0;
+    m_records = 0;
+    m_header = PhotonsCompactHeader();
+    m_file.close();
+}
+
+PhotonsCompactRecord PhotonsCompactReader::record(quint64 n) const
+{
+    PhotonsCompactRecord r = m_records[n];
+    r.x = qFromLittleEndian(r.x);
+    r.y = qFromLittleEndian(r.y);
+    r.z = qFromLittleEndian(r.z);
+    r.surface = qFromLittleEndian(r.surface);
+    r.info = qFromLittleEndian(r.info);
+    return r;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <QFile>
+#include <QtEndian>
+
+
+//! Header of a compact photon file (*.tph), 32 bytes, little-endian.
+struct TONATIUH_KERNEL PhotonsCompactHeader
+{
+    PhotonsCompactHeader();
+
+    bool isValid() const;
+    bool isLocal() const {return flags & FlagLocal;}
+
+    enum Flags {
+        FlagLocal = 1 // coordinates in the frame of the surface
+    };
+    static const quint32 Version = 1;
+
+    char magic[4]; // "TPHC"
+    quint32 version;
+    quint32 recordSize; // bytes per photon
+    quint32 flags;
+    quint64 count; // number of photons
+    double power; // power of one photon
+};
+
+
+//! Photon record of a compact photon file, 20 bytes, little-endian.
+/*!
+ * Surface ids start from 1 and refer to the list of surfaces in the parameters file, 0 for air.
+ * A record with id 0 starts a new ray path, the other records continue the path of the previous one.
+ */
+struct TONATIUH_KERNEL PhotonsCompactRecord
+{
+    float x, y, z;
+    quint32 surface;
+    quint32 info; // id, front and absorbed bits
+
+    static const quint32 IdMask = 0x3FFFFFFF;
+    static const quint32 FrontBit = 1u << 30;
+    static const quint32 AbsorbedBit = 1u << 31;
+
+    int id() const {return int(info & IdMask);}
+    bool isFront() const {return info & FrontBit;}
+    bool isAbsorbed() const {return info & AbsorbedBit;}
+};
+
+static_assert(sizeof(PhotonsCompactHeader) == 32, "PhotonsCompactHeader");
+static_assert(sizeof(PhotonsCompactRecord) == 20, "PhotonsCompactRecord");
+
+
+//! PhotonsCompactReader maps a compact photon file into memory.
+/*!
+ * The records are accessed in place without reading the whole file.
+ */
+class TONATIUH_KERNEL PhotonsCompactReader
+{
+public:
+    PhotonsCompactReader();
+    ~PhotonsCompactReader();
+
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const {return m_data != 0;}
+
+    const PhotonsCompactHeader& header() const {return m_header;}
+    quint64 size() const {return m_header.count;}
+    double photonPower() const {return m_header.power;}
+
+    // raw records, in host order on little-endian machines
+    const PhotonsCompactRecord* records() const {return m_records;}
+    PhotonsCompactRecord record(quint64 n) const;
+
+private:
+    QFile m_file;
+    uchar* m_data;
+    const PhotonsCompactRecord* m_records;
+    PhotonsCompactHeader m_header;
+};
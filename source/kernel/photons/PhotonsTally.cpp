@@ -0,0 +1,129 @@
+#include "PhotonsTally.h"
+
+#include "kernel/photons/Photon.h"
+#include "kernel/profiles/ProfileRT.h"
+#include "kernel/run/InstanceNode.h"
+#include "kernel/scene/TShapeKit.h"
+#include "kernel/shape/ShapeRT.h"
+
+
+PhotonsTally::PhotonsTally(const QVector<InstanceNode*>& surfaces):
+    m_surfaces(surfaces),
+    m_surface(-1),
+    m_isFront(true),
+    m_rows(0),
+    m_cols(0),
+    m_shape(0)
+{
+    m_counts.hits.resize(2*surfaces.size(), 0);
+}
+
+/*!
+ * Enables the histogram of \a rows x \a cols cells on the side \a isFront of \a surface.
+ * The surface must be one of the tallied surfaces.
+ */
+bool PhotonsTally::setHistogram(InstanceNode* surface, bool isFront, int rows, int cols)
+{
+    m_surface = m_surfaces.indexOf(surface);
+    if (m_surface < 0 || rows <= 0 || cols <= 0) {
+        m_surface = -1;
+        return false;
+    }
+
+    TShapeKit* kit = (TShapeKit*) surface->getNode();
+    m_shape = (ShapeRT*) kit->shapeRT.getValue();
+    ProfileRT* profile = (ProfileRT*) kit->profileRT.getValue();
+    if (!m_shape || !profile) {
+        m_surface = -1;
+        return false;
+    }
+
+    m_isFront = isFront;
+    m_rows = rows;
+    m_cols = cols;
+    m_toObject = surface->getTransform().inversed();
+    m_box = profile->getBox();
+    m_counts.bins.assign(rows*cols, 0);
+    return true;
+}
+
+PhotonsTally::Counts PhotonsTally::makeCounts() const
+{
+    Counts counts;
+    counts.hits.resize(m_counts.hits.size(), 0);
+    counts.bins.resize(m_counts.bins.size(), 0);
+    return counts;
+}
+
+void PhotonsTally::record(Counts& counts, InstanceNode* surface, const vec3d& pos, bool isFront) const
+{
+    int n = m_surfaces.indexOf(surface);
+    if (n < 0) return;
+    counts.hits[2*n + isFront]++;
+
+    if (n != m_surface || isFront != m_isFront) return;
+    vec2d uv = m_shape->getUV(m_toObject.transformPoint(pos));
+    vec2i cell = findCell(m_box.toNormalized(uv), m_rows, m_cols);
+    counts.bins[cell.x*m_cols + cell.y]++;
+}
+
+void PhotonsTally::add(const Counts& counts)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t n = 0; n < m_counts.hits.size(); ++n)
+        m_counts.hits[n] += counts.hits[n];
+    for (size_t n = 0; n < m_counts.bins.size(); ++n)
+        m_counts.bins[n] += counts.bins[n];
+}
+
+void PhotonsTally::add(const std::vector<Photon>& photons)
+{
+    Counts counts = makeCounts();
+    for (const Photon& photon : photons)
+        record(counts, photon.surface, photon.pos, photon.isFront);
+    add(counts);
+}
+
+ulong PhotonsTally::getHits(InstanceNode* surface, bool isFront) const
+{
+    int n = m_surfaces.indexOf(surface);
+    if (n < 0) return 0;
+    return m_counts.hits[2*n + isFront];
+}
+
+Matrix2D<int> PhotonsTally::getHistogram() const
+{
+    Matrix2D<int> ans(m_rows, m_cols);
+    for (int r = 0; r < m_rows; ++r)
+        for (int c = 0; c < m_cols; ++c)
+            ans(r, c) = int(m_counts.bins[r*m_cols + c]);
+    return ans;
+}
+
+/*!
+ * Divides the power of the photons in each cell of \a bins by the area of the cell on \a surface.
+ * The cells divide the box of the profile as in setHistogram.
+ */
+Matrix2D<double> PhotonsTally::findFlux(InstanceNode* surface, const Matrix2D<int>& bins, double powerPhoton)
+{
+    Matrix2D<double> ans(bins.rows(), bins.cols());
+    ans.fill(0.);
+
+    TShapeKit* kit = (TShapeKit*) surface->getNode();
+    ShapeRT* shape = (ShapeRT*) kit->shapeRT.getValue();
+    ProfileRT* profile = (ProfileRT*) kit->profileRT.getValue();
+    if (!shape || !profile) return ans;
+    Box2D box = profile->getBox();
+    Transform toWorld = surface->getTransform();
+
+    double uStep = box.size().x/bins.rows();
+    double vStep = box.size().y/bins.cols();
+    for (int r = 0; r < bins.rows(); ++r) {
+        for (int c = 0; c < bins.cols(); ++c) {
+            double u0 = box.min().x + r*uStep;
+            double v0 = box.min().y + c*vStep;
+            ans(r, c) = bins(r, c)*powerPhoton/shape->findArea(u0, v0, u0 + uStep, v0 + vStep, toWorld);
+        }
+    }
+    return ans;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include <QVector>
+
+#include "libraries/math/2D/Box2D.h"
+#include "libraries/math/2D/Matrix2D.h"
+#include "libraries/math/2D/vec2i.h"
+#include "libraries/math/3D/Transform.h"
+#include "kernel/run/InstanceSet.h"
+
+class InstanceNode;
+class ShapeRT;
+struct Photon;
+struct vec3d;
+
+
+//! PhotonsTally counts the photons on surfaces instead of storing them.
+/*!
+ * Each ray tracing batch records into its own Counts and adds them once at the end,
+ * so the tracing threads share no memory during the batch.
+ * Optionally a histogram in the uv-space of one surface is accumulated.
+ */
+class TONATIUH_KERNEL PhotonsTally
+{
+public:
+    PhotonsTally(const QVector<InstanceNode*>& surfaces); // after InstanceNode::updateTree
+
+    // call after InstanceNode::updateTree
+    bool setHistogram(InstanceNode* surface, bool isFront, int rows, int cols);
+
+    struct Counts
+    {
+        std::vector<ulong> hits; // front and back for each surface
+        std::vector<ulong> bins;
+    };
+
+    Counts makeCounts() const;
+    void record(Counts& counts, InstanceNode* surface, const vec3d& pos, bool isFront) const;
+    void add(const Counts& counts);
+    void add(const std::vector<Photon>& photons); // stored in a buffer
+
+    const QVector<InstanceNode*>& getSurfaces() const {return m_surfaces.instances();}
+    ulong getHits(InstanceNode* surface, bool isFront) const;
+    Matrix2D<int> getHistogram() const;
+    const Box2D& getHistogramBox() const {return m_box;}
+
+    // cell of the point q normalized to the box, clamped to the grid
+    static vec2i findCell(const vec2d& q, int rows, int cols);
+    // flux (W/m2) of the cells of a histogram over the profile of surface
+    static Matrix2D<double> findFlux(InstanceNode* surface, const Matrix2D<int>& bins, double powerPhoton);
+
+private:
+    InstanceSet m_surfaces;
+    Counts m_counts;
+
+    // histogram
+    int m_surface; // index in m_surfaces, -1 for none
+    bool m_isFront;
+    int m_rows;
+    int m_cols;
+    ShapeRT* m_shape;
+    Transform m_toObject;
+    Box2D m_box;
+
+    std::mutex m_mutex;
+};
+
+
+inline vec2i PhotonsTally::findCell(const vec2d& q, int rows, int cols)
+{
+    return vec2i(
+        std::clamp(int(floor(q.x*rows)), 0, rows - 1),
+        std::clamp(int(floor(q.y*cols)), 0, cols - 1)
+    );
+}
@@ -14,6 +14,8 @@ ProfileBox::ProfileBox()
     isBuiltIn = TRUE;
     SO_NODE_ADD_FIELD( uSize, (1.) );
     SO_NODE_ADD_FIELD( vSize, (1.) );
+
+    attachSensor();
 }
 
 Box2D ProfileBox::getBox() const
@@ -31,8 +33,8 @@ void ProfileBox::setBox(const Box2D& box)
 
 bool ProfileBox::isInside(double u, double v) const
 {
-    return 2.*std::abs(u) <= uSize.getValue() &&
-           2.*std::abs(v) <= vSize.getValue();
+    return std::abs(u) <= m_halfSize.x &&
+           std::abs(v) <= m_halfSize.y;
 }
 
 QVector<vec2d> ProfileBox::makeMesh(QSize& dims) const
@@ -52,3 +54,8 @@ QVector<vec2d> ProfileBox::makeMesh(QSize& dims) const
     }
     return ans;
 }
+
+void ProfileBox::updateCache()
+{
+    m_halfSize = vec2d(uSize.getValue()/2., vSize.getValue()/2.);
+}
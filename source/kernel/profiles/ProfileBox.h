@@ -21,4 +21,9 @@ public:
     QVector<vec2d> makeMesh(QSize& dims) const;
 
     NAME_ICON_FUNCTIONS("Box", ":/profiles/ProfileBox.png")
+
+protected:
+    vec2d m_halfSize;
+
+    void updateCache();
 };
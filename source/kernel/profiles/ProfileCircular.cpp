@@ -27,6 +27,8 @@ ProfileCircular::ProfileCircular()
 
 //    SO_NODE_ADD_FIELD( phiMin, ("-180d) );
 //    SO_NODE_ADD_FIELD( phiMax, ("180d") );
+
+    attachSensor();
 }
 
 Box2D ProfileCircular::getBox() const
@@ -76,11 +78,11 @@ void ProfileCircular::setBox(const Box2D& box)
 bool ProfileCircular::isInside(double u, double v) const
 {
     double r2 = u*u + v*v;
-    if (r2 < gcf::pow2(rMin.getValue())) return false;
-    if (r2 > gcf::pow2(rMax.getValue())) return false;
+    if (r2 < m_r2Min) return false;
+    if (r2 > m_r2Max) return false;
     double phi = atan2(v, u);
-    if (phi < phiMin.getValue()) return false;
-    if (phi > phiMax.getValue()) return false;
+    if (phi < m_phiMin) return false;
+    if (phi > m_phiMax) return false;
     return true;
 }
 
@@ -103,3 +105,11 @@ QVector<vec2d> ProfileCircular::makeMesh(QSize& dims) const
     }
     return ans;
 }
+
+void ProfileCircular::updateCache()
+{
+    m_r2Min = gcf::pow2(rMin.getValue());
+    m_r2Max = gcf::pow2(rMax.getValue());
+    m_phiMin = phiMin.getValue();
+    m_phiMax = phiMax.getValue();
+}
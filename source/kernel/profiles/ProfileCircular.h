@@ -25,5 +25,10 @@ public:
     NAME_ICON_FUNCTIONS("Circular", ":/profiles/ProfileCircular.png")
 
 protected:
-    ~ProfileCircular() {}
+    double m_r2Min;
+    double m_r2Max;
+    double m_phiMin;
+    double m_phiMax;
+
+    void updateCache();
 };
@@ -18,6 +18,8 @@ ProfileRectangular::ProfileRectangular()
     SO_NODE_ADD_FIELD( uMax, (0.5) );
     SO_NODE_ADD_FIELD( vMin, (-0.5) );
     SO_NODE_ADD_FIELD( vMax, (0.5) );
+
+    attachSensor();
 }
 
 Box2D ProfileRectangular::getBox() const
@@ -38,8 +40,8 @@ void ProfileRectangular::setBox(const Box2D& box)
 
 bool ProfileRectangular::isInside(double u, double v) const
 {
-    return uMin.getValue() <= u && u <= uMax.getValue() &&
-           vMin.getValue() <= v && v <= vMax.getValue();
+    return m_box.min().x <= u && u <= m_box.max().x &&
+           m_box.min().y <= v && v <= m_box.max().y;
 }
 
 QVector<vec2d> ProfileRectangular::makeMesh(QSize& dims) const
@@ -57,3 +59,8 @@ QVector<vec2d> ProfileRectangular::makeMesh(QSize& dims) const
     }
     return ans;
 }
+
+void ProfileRectangular::updateCache()
+{
+    m_box = getBox();
+}
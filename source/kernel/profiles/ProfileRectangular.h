@@ -23,4 +23,9 @@ public:
     QVector<vec2d> makeMesh(QSize& dims) const;
 
     NAME_ICON_FUNCTIONS("Rectangular", ":/profiles/ProfileRectangular.png")
+
+protected:
+    Box2D m_box;
+
+    void updateCache();
 };
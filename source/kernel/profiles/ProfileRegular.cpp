@@ -15,6 +15,8 @@ ProfileRegular::ProfileRegular()
     SO_NODE_CONSTRUCTOR(ProfileRegular);
     SO_NODE_ADD_FIELD( r, (1.) );
     SO_NODE_ADD_FIELD( n, (6) );
+
+    attachSensor();
 }
 
 Box2D ProfileRegular::getBox() const
@@ -33,16 +35,12 @@ void ProfileRegular::setBox(const Box2D& box)
 bool ProfileRegular::isInside(double u, double v) const
 {
     double r2 = u*u + v*v;
-    double rOut = r.getValue();
-    if (r2 > rOut*rOut) return false;
-
-    double phiStep = gcf::TwoPi/n.getValue();
-    double rIn = rOut*cos(phiStep/2.);
-    if (r2 < rIn*rIn) return true;
+    if (r2 > m_rOut*m_rOut) return false;
+    if (r2 < m_rIn*m_rIn) return true;
 
-    double phi = atan2(v, u) + phiStep/2. + 90.*gcf::degree;
-    phi -= std::floor(phi/phiStep)*phiStep + phiStep/2.;
-    return sqrt(r2)*cos(phi) < rIn;
+    double phi = atan2(v, u) + m_phiStep/2. + 90.*gcf::degree;
+    phi -= std::floor(phi/m_phiStep)*m_phiStep + m_phiStep/2.;
+    return sqrt(r2)*cos(phi) < m_rIn;
 }
 
 QVector<vec2d> ProfileRegular::makeMesh(QSize& dims) const
@@ -67,3 +65,10 @@ QVector<vec2d> ProfileRegular::makeMesh(QSize& dims) const
     }
     return ans;
 }
+
+void ProfileRegular::updateCache()
+{
+    m_rOut = r.getValue();
+    m_phiStep = gcf::TwoPi/n.getValue();
+    m_rIn = m_rOut*cos(m_phiStep/2.);
+}
@@ -23,5 +23,9 @@ public:
     NAME_ICON_FUNCTIONS("Regular", ":/profiles/ProfileRegular.png")
 
 protected:
-    ~ProfileRegular() {}
+    double m_rOut;
+    double m_rIn;
+    double m_phiStep;
+
+    void updateCache();
 };
@@ -2,8 +2,6 @@
 #include "kernel/node/TonatiuhFunctions.h"
 #include "libraries/math/gcf.h"
 
-#include <Inventor/sensors/SoNodeSensor.h>
-
 
 SO_NODE_SOURCE(ProfileTriangle)
 
@@ -19,9 +17,7 @@ ProfileTriangle::ProfileTriangle()
     SO_NODE_ADD_FIELD( b, (-0.5, 0.5) );
     SO_NODE_ADD_FIELD( c, (-0.5, -0.5) );
 
-    m_sensor = new SoNodeSensor(onSensor, this);
-    m_sensor->attach(this);
-    onSensor(this, 0);
+    attachSensor();
 }
 
 Box2D ProfileTriangle::getBox() const
@@ -70,23 +66,16 @@ QVector<vec2d> ProfileTriangle::makeMesh(QSize& dims) const
     return ans;
 }
 
-ProfileTriangle::~ProfileTriangle()
+void ProfileTriangle::updateCache()
 {
-    delete m_sensor;
-}
-
-void ProfileTriangle::onSensor(void* data, SoSensor*)
-{
-    ProfileTriangle* profile = (ProfileTriangle*) data;
-
-    vec2d pAC = tgf::makeVector2D(profile->a.getValue());
-    vec2d pBC = tgf::makeVector2D(profile->b.getValue());
-    vec2d pC = tgf::makeVector2D(profile->c.getValue());
+    vec2d pAC = tgf::makeVector2D(a.getValue());
+    vec2d pBC = tgf::makeVector2D(b.getValue());
+    vec2d pC = tgf::makeVector2D(c.getValue());
     pAC -= pC;
     pBC -= pC;
 
-    profile->m_pAC = pAC;
-    profile->m_pBC = pBC;
-    profile->m_pC = pC;
-    profile->m_det = cross(pAC, pBC);
+    m_pAC = pAC;
+    m_pBC = pBC;
+    m_pC = pC;
+    m_det = cross(pAC, pBC);
 }
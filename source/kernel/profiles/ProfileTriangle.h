@@ -25,13 +25,10 @@ public:
     NAME_ICON_FUNCTIONS("Triangle", ":/profiles/ProfileTriangle.png")
 
 protected:
-    ~ProfileTriangle();
-
     vec2d m_pAC;
     vec2d m_pBC;
     vec2d m_pC;
     double m_det;
 
-    SoNodeSensor* m_sensor;
-    static void onSensor(void* data, SoSensor*);
+    void updateCache();
 };
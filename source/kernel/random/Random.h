@@ -35,6 +35,10 @@ public:
 
     virtual void FillArray(std::vector<double>& array) = 0;
 
+    // independent generator of the same type for parallel streams
+    // returns 0 if not supported
+    virtual Random* createStream(ulong seed) const {Q_UNUSED(seed) return 0;}
+
     ulong NumbersGenerated() const {return m_total;}
     ulong NumbersProvided() const {return m_total - m_array.size() + m_index;}
 
@@ -55,6 +59,7 @@ class RandomFactory: public TFactory
 {
 public:
     virtual Random* create(int) const = 0;
+    virtual Random* create(int, ulong seed) const = 0;
 };
 
 Q_DECLARE_INTERFACE(RandomFactory, "tonatiuh.RandomFactory")
@@ -70,4 +75,6 @@ public:
         ulong seed = QTime::currentTime().msec();
         return new T(seed);
     }
+
+    T* create(int, ulong seed) const {return new T(seed);}
 };
@@ -1,17 +1,31 @@
 #include "RandomParallel.h"
 
+#include <random>
 
-RandomParallel::RandomParallel(Random* rand, QMutex* mutex, ulong size):
-    Random(size),
-    m_rand(rand),
-    m_mutex(mutex)
+#include "RandomSTL.h"
+
+
+RandomParallel::RandomParallel(Random* rand, ulong seed, ulong stream, ulong size):
+    Random(size)
 {
+    std::seed_seq sequence{
+        quint32(seed), quint32(quint64(seed) >> 32),
+        quint32(stream), quint32(quint64(stream) >> 32)
+    };
+    quint32 seeds[2];
+    sequence.generate(seeds, seeds + 2);
+    ulong seedStream = ulong(quint64(seeds[0]) | quint64(seeds[1]) << 32);
 
+    m_rand = rand ? rand->createStream(seedStream) : 0;
+    if (!m_rand) m_rand = new RandomSTL(seedStream, 0);
+}
+
+RandomParallel::~RandomParallel()
+{
+    delete m_rand;
 }
 
 void RandomParallel::FillArray(std::vector<double>& array)
 {
-    m_mutex->lock();
     m_rand->FillArray(array);
-    m_mutex->unlock();
 }
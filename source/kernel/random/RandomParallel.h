@@ -2,20 +2,24 @@
 
 #include "kernel/TonatiuhKernel.h"
 
-#include <QMutex>
-
 #include "Random.h"
 
 
+//!  RandomParallel is a random stream for a single worker.
+/*!
+   The stream is created from the generator \a rand and seeded with \a seed and \a stream.
+   Different stream numbers give independent sequences, so the workers do not share a generator
+   and the results do not depend on the thread scheduling.
+ */
 class TONATIUH_KERNEL RandomParallel: public Random
 {
 
 public:
-    RandomParallel(Random* rand, QMutex* mutex, ulong size = 100'000);
+    RandomParallel(Random* rand, ulong seed, ulong stream, ulong size = 100'000);
+    ~RandomParallel();
 
     void FillArray(std::vector<double>& array);
 
 protected:
     Random* m_rand;
-    QMutex* m_mutex;
 };
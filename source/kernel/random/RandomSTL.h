@@ -10,6 +10,7 @@ public:
     RandomSTL(ulong seed, ulong size = 10'000'000);
 
     void FillArray(std::vector<double>& array);
+    Random* createStream(ulong seed) const {return new RandomSTL(seed, 0);}
 
     NAME_ICON_FUNCTIONS("Mersenne-Twister(STL)", ":/RandomX.png")
 
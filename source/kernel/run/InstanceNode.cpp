@@ -2,11 +2,13 @@
 
 #include <iostream>
 
+#include <Inventor/nodes/SoGroup.h>
 #include <Inventor/nodes/SoNode.h>
 #include <Inventor/actions/SoGetBoundingBoxAction.h>
 
 #include "kernel/node/TonatiuhFunctions.h"
 #include "kernel/material/MaterialTransparent.h"
+#include "kernel/scene/TArrayKit.h"
 #include "kernel/scene/TSeparatorKit.h"
 #include "kernel/shape/ShapeRT.h"
 #include "libraries/math/3D/Box3D.h"
@@ -19,7 +21,7 @@
 
 
 InstanceNode::InstanceNode(SoNode* node):
-    m_node(node), m_parent(0)
+    m_node(node), m_parent(0), m_id(-1)
 {
 
 }
@@ -55,6 +57,40 @@ void InstanceNode::replaceChild(int row, InstanceNode* child)
     child->m_parent = this;
 }
 
+/**
+ * Adds an instance for each child node, recursively.
+ **/
+void InstanceNode::generateTree()
+{
+    for (SoNode* node : getChildNodes(m_node))
+    {
+        InstanceNode* child = new InstanceNode(node);
+        addChild(child);
+        child->generateTree();
+    }
+}
+
+/**
+ * Nodes below \a node in the instance tree:
+ * the group of a TSeparatorKit or the shared child of a TArrayKit.
+ **/
+QVector<SoNode*> InstanceNode::getChildNodes(SoNode* node)
+{
+    QVector<SoNode*> ans;
+    if (TSeparatorKit* kit = dynamic_cast<TSeparatorKit*>(node))
+    {
+        SoGroup* group = (SoGroup*) kit->getPart("group", false);
+        if (!group) return ans;
+        for (int n = 0; n < group->getNumChildren(); ++n)
+            ans << group->getChild(n);
+    }
+    else if (TArrayKit* kit = dynamic_cast<TArrayKit*>(node))
+    {
+        if (kit->child.getValue()) ans << kit->child.getValue();
+    }
+    return ans;
+}
+
 bool InstanceNode::operator==(const InstanceNode& other)
 {
     return
@@ -155,9 +191,18 @@ void InstanceNode::extendBoxForLight(SbBox3f* extendedBox)
 
 /**
  * Set node world to object transform to \a nodeTransform .
+ * The instances of the tree are numbered from 0 in depth-first order,
+ * so surfaces can be looked up by id during ray tracing.
  */
 void InstanceNode::updateTree(const Transform& tParent)
 {
+    int id = 0;
+    updateTree(tParent, id);
+}
+
+void InstanceNode::updateTree(const Transform& tParent, int& id)
+{
+    m_id = id++;
     if (TSeparatorKit* separatorKit = dynamic_cast<TSeparatorKit*>(m_node))
     {
         TTransform* t = SO_GET_PART(separatorKit, "transform", TTransform);
@@ -167,7 +212,7 @@ void InstanceNode::updateTree(const Transform& tParent)
         Box3D box;
         for (InstanceNode* child : children)
         {
-            child->updateTree(m_transform);
+            child->updateTree(m_transform, id);
             box.expand(child->m_box);
         }
         m_box = box;
@@ -185,6 +230,33 @@ void InstanceNode::updateTree(const Transform& tParent)
         ProfileRT* profile = (ProfileRT*) kit->profileRT.getValue();
         m_box = m_transform(shape->getBox(profile));
     }
+    else if (TArrayKit* arrayKit = dynamic_cast<TArrayKit*>(m_node))
+    {
+        // the child is kept in the frame of the array
+        m_transform = tParent;
+        Box3D box;
+        for (InstanceNode* child : children)
+        {
+            child->updateTree(Transform::Identity, id);
+            box.expand(child->m_box);
+        }
+
+        m_box = Box3D();
+        if (box.isValid()) {
+            for (int n = 0; n < arrayKit->positions.getNum(); ++n)
+                m_box.expand(getCopyTransform(n)(box));
+        }
+    }
+}
+
+/**
+ * Transform of copy \a n of a TArrayKit instance from the frame of its child to world.
+ **/
+Transform InstanceNode::getCopyTransform(int n) const
+{
+    TArrayKit* kit = (TArrayKit*) m_node;
+    const SbVec3f& p = kit->positions[n];
+    return m_transform*Transform::translate(p[0], p[1], p[2]);
 }
 
 void InstanceNode::collectShapeTransforms(QStringList disabledNodes, QVector<QPair<TShapeKit*, Transform> >& shapes)
@@ -200,6 +272,19 @@ void InstanceNode::collectShapeTransforms(QStringList disabledNodes, QVector<QPa
     {
         shapes << QPair<TShapeKit*, Transform>(shape, m_transform);
     }
+    else if (TArrayKit* kit = dynamic_cast<TArrayKit*>(m_node))
+    {
+        QVector<QPair<TShapeKit*, Transform> > shapesChild;
+        for (InstanceNode* child : children)
+            child->collectShapeTransforms(disabledNodes, shapesChild);
+
+        for (int n = 0; n < kit->positions.getNum(); ++n)
+        {
+            Transform t = getCopyTransform(n);
+            for (const QPair<TShapeKit*, Transform>& s : shapesChild)
+                shapes << QPair<TShapeKit*, Transform>(s.first, t*s.second);
+        }
+    }
 }
 
 QDataStream& operator<<(QDataStream& s, const InstanceNode& node)
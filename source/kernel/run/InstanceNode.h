@@ -36,15 +36,21 @@ public:
     InstanceNode* getParent() const {return m_parent;}
     void setParent(InstanceNode* parent) {m_parent = parent;}
 
+    int getId() const {return m_id;} // dense in the tree of updateTree, -1 before
+
     const Box3D& getBox() const {return m_box;}
     void setBox(const Box3D& box) {m_box = box;}
 
     const Transform& getTransform() {return m_transform;}
     void setTransform(const Transform& t) {m_transform = t;}
+    Transform getCopyTransform(int n) const; // for TArrayKit
 
     void addChild(InstanceNode* child);
     void insertChild(int row, InstanceNode* child);
     void replaceChild(int row, InstanceNode* child);
+    void generateTree(); // for the children of the node
+
+    static QVector<SoNode*> getChildNodes(SoNode* node); // of TSeparatorKit and TArrayKit
 
     bool operator==(const InstanceNode& other);
     QString getURL() const;
@@ -54,14 +60,17 @@ public:
 
     void extendBoxForLight(SbBox3f* extendedBox);
 
-    void updateTree(const Transform& tParent);
+    void updateTree(const Transform& tParent); // also numbers the instances
     void collectShapeTransforms(QStringList disabledNodes, QVector<QPair<TShapeKit*, Transform> >& shapes);
 
     QVector<InstanceNode*> children;
 
 private:
+    void updateTree(const Transform& tParent, int& id);
+
     SoNode* m_node;
     InstanceNode* m_parent;
+    int m_id;
     Box3D m_box; // in world frame
     Transform m_transform; // from object to world
 };
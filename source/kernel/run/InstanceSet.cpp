@@ -0,0 +1,29 @@
+#include "InstanceSet.h"
+
+#include "kernel/run/InstanceNode.h"
+
+
+InstanceSet::InstanceSet(const QVector<InstanceNode*>& instances):
+    m_instances(instances)
+{
+    for (int n = 0; n < instances.size(); ++n)
+    {
+        InstanceNode* instance = instances[n];
+        if (!instance) continue;
+        int id = instance->getId();
+        if (id < 0) continue;
+        if (id >= int(m_indices.size()))
+            m_indices.resize(id + 1, -1);
+        if (m_indices[id] < 0) m_indices[id] = n;
+    }
+}
+
+int InstanceSet::indexOf(const InstanceNode* instance) const
+{
+    if (!instance) return -1;
+    int id = instance->getId();
+    if (id < 0 || id >= int(m_indices.size())) return -1;
+    int n = m_indices[id];
+    if (n < 0 || m_instances[n] != instance) return -1; // from another tree
+    return n;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <vector>
+
+#include <QVector>
+
+class InstanceNode;
+
+
+//! InstanceSet finds the position of an instance in a list by its id.
+/*!
+ * The list is stored as a table over the ids of InstanceNode::updateTree,
+ * the lookup is constant time instead of a search in the list.
+ * Build it after updateTree, instances without id are not found.
+ */
+class TONATIUH_KERNEL InstanceSet
+{
+public:
+    InstanceSet() {}
+    InstanceSet(const QVector<InstanceNode*>& instances);
+
+    int indexOf(const InstanceNode* instance) const;
+    bool contains(const InstanceNode* instance) const {return indexOf(instance) >= 0;}
+
+    const QVector<InstanceNode*>& instances() const {return m_instances;}
+
+private:
+    QVector<InstanceNode*> m_instances;
+    std::vector<int> m_indices; // by id, -1 if not in list
+};
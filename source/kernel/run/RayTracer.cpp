@@ -4,7 +4,9 @@
 #include "random/RandomParallel.h"
 #include "libraries/math/3D/Ray.h"
 #include "RayTracer.h"
+#include "SceneBVH.h"
 #include "kernel/photons/PhotonsBuffer.h"
+#include "kernel/photons/PhotonsTally.h"
 #include "sun/SunAperture.h"
 #include "sun/SunShape.h"
 #include "air/AirTransmission.h"
@@ -16,37 +18,62 @@ RayTracer::RayTracer(InstanceNode* instanceRoot,
     SunShape* sunShape,
     AirTransmission* air,
     Random* rand,
-    QMutex* mutexRand,
     PhotonsBuffer* photonBuffer,
-    QMutex* mutexPhotons,
     QVector<InstanceNode*> exportSuraceList
 ):
     m_instanceLayout(instanceRoot),
+    m_scene(std::make_shared<SceneBVH>(instanceRoot)),
     m_instanceSun(instanceSun),
     m_sunAperture(sunAperture),
     m_sunShape(sunShape),
     m_sunTransform(instanceSun->getTransform()),
     m_air(air),
     m_rand(rand),
-    m_mutexRand(mutexRand),
     m_photonBuffer(photonBuffer),
-    m_mutexPhotonsBuffer(mutexPhotons),
-    m_exportSurfaceList(exportSuraceList),
-    m_sunCells(sunAperture->getCells())
-{   
+    m_tally(0),
+    m_exportSurfaces(exportSuraceList)
+{
+    // seed of this run, different runs continue the sequence of rand
+    m_seed = ulong(rand->RandomDouble()*4294967296.);
+}
+
+/**
+ * Splits \a nRays into \a nBatches work items (plus one for the remainder).
+ **/
+QVector<RayTracer::Batch> RayTracer::makeBatches(ulong nRays, int nBatches)
+{
+    QVector<Batch> batches;
+    ulong nRaysBatch = nRays/nBatches;
+    for (int n = 0; n < nBatches; ++n)
+        batches << Batch{nRaysBatch, ulong(n)};
 
+    if (nRaysBatch*nBatches < nRays)
+        batches << Batch{nRays - nRaysBatch*nBatches, ulong(nBatches)};
+    return batches;
 }
 
-void RayTracer::operator()(ulong nRays)
+void RayTracer::operator()(const Batch& batch)
 {
-    if (m_sunCells.empty()) return;
-    bool bExportAll = m_exportSurfaceList.empty();
-    bool bExportLight = bExportAll ? true : m_exportSurfaceList.contains(m_instanceSun);
+    ulong nRays = batch.rays;
+    if (m_sunAperture->getCells().empty()) return;
+    bool bExportAll = m_exportSurfaces.instances().empty();
+    bool bExportLight = bExportAll ? true : m_exportSurfaces.instances().contains(m_instanceSun);
 
     std::vector<Photon> photons;
-    photons.reserve(2*nRays);
-    // Photon(Point3D pos, int side, double id = 0, InstanceNode* intersectedSurface = 0, int absorbedPhoton = 0);
-    RandomParallel rand(m_rand, m_mutexRand);
+    PhotonsTally::Counts counts;
+    if (m_tally)
+        counts = m_tally->makeCounts();
+    else
+        photons.reserve(2*nRays);
+
+    auto addPhoton = [&](int id, const vec3d& pos, InstanceNode* surface, bool isFront, bool isAbsorbed = false) {
+        if (m_tally)
+            m_tally->record(counts, surface, pos, isFront);
+        else
+            photons.push_back(Photon(id, pos, surface, isFront, isAbsorbed));
+    };
+
+    RandomParallel rand(m_rand, m_seed, batch.stream);
 
     for (ulong n = 0; n < nRays; ++n)
     {
@@ -57,7 +84,7 @@ void RayTracer::operator()(ulong nRays)
         int rayLength = 0;
         InstanceNode* intersectedSurface = m_instanceSun;
         if (bExportLight)
-            photons.push_back(Photon(rayLength, ray.origin, m_instanceSun, isFront));
+            addPhoton(rayLength, ray.origin, m_instanceSun, isFront);
 
         // Part 2: middle photon points (intersection with shapes)
         bool isReflected = true;
@@ -65,7 +92,7 @@ void RayTracer::operator()(ulong nRays)
             Ray rayReflected; // scattered?
             isFront = false;
             intersectedSurface = 0;
-            isReflected = m_instanceLayout->intersect(ray, rand, isFront, intersectedSurface, rayReflected);
+            isReflected = m_scene->intersect(ray, rand, isFront, intersectedSurface, rayReflected);
 
             // check absorption after the first reflection
             if (m_air && rayLength > 0) {
@@ -80,34 +107,35 @@ void RayTracer::operator()(ulong nRays)
             // save intersection
             if (!isReflected) break;
             ++rayLength;
-            if (bExportAll || m_exportSurfaceList.contains(intersectedSurface))
-                photons.push_back(Photon(rayLength, ray.point(ray.tMax), intersectedSurface, isFront, true));
+            if (bExportAll || m_exportSurfaces.contains(intersectedSurface))
+                addPhoton(rayLength, ray.point(ray.tMax), intersectedSurface, isFront, true);
             ray = rayReflected;
         }
 
         // Part 3: last photon point (absorption in air)
         // skip rays without intersections
         if (rayLength == 0 && ray.tMax == gcf::infinity) continue;
-        if (!bExportAll && !m_exportSurfaceList.contains(intersectedSurface)) continue;
+        if (!bExportAll && !m_exportSurfaces.contains(intersectedSurface)) continue;
         // limit length of other rays
         if (ray.tMax == gcf::infinity) {// always true?
             ray.tMax = 1.;
             isFront = 0; // ? back for air
         }
-        photons.push_back(Photon(++rayLength, ray.point(ray.tMax), intersectedSurface, isFront));
+        addPhoton(++rayLength, ray.point(ray.tMax), intersectedSurface, isFront);
     }
 
-    m_mutexPhotonsBuffer->lock();
-    m_photonBuffer->addPhotons(photons);
-    m_mutexPhotonsBuffer->unlock();
+    if (m_tally)
+        m_tally->add(counts);
+    else
+        m_photonBuffer->addPhotons(photons);
 }
 
 bool RayTracer::NewPrimitiveRay(Ray* ray, Random& rand)
 {
-    int index = int(rand.RandomDouble()*m_sunCells.size());
-    QPair<int, int> cell = m_sunCells[index];
-
-    vec3d origin = m_sunAperture->Sample(rand.RandomDouble(), rand.RandomDouble(), cell.first, cell.second);
+    double s = rand.RandomDouble();
+    double u = rand.RandomDouble();
+    double v = rand.RandomDouble();
+    vec3d origin = m_sunAperture->Sample(s, u, v);
     vec3d direction = m_sunShape->generateRay(rand);
     *ray = m_sunTransform(Ray(origin, direction));
     return true;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kernel/TonatiuhKernel.h"
+#include <memory>
 #include <vector>
 
 #include <QVector>
@@ -9,15 +10,17 @@
 #include <QObject>
 
 #include "libraries/math/3D/Transform.h"
+#include "kernel/run/InstanceSet.h"
 
 class InstanceNode;
+class SceneBVH;
 class RandomParallel;
 struct Photon;
 class Random;
 struct RayTracerPhoton;
-class QMutex;
 class QPoint;
 class PhotonsBuffer;
+class PhotonsTally;
 class SunAperture;
 class SunShape;
 class AirTransmission;
@@ -33,29 +36,37 @@ public:
               SunShape* sunShape,
               AirTransmission* air,
               Random* rand,
-              QMutex* mutexRand,
               PhotonsBuffer* photonBuffer,
-              QMutex* mutexPhotons,
               QVector<InstanceNode*> exportSuraceList);
 
+    // rays for one work item, each item has its own random stream
+    struct Batch
+    {
+        ulong rays;
+        ulong stream;
+    };
+    static QVector<Batch> makeBatches(ulong nRays, int nBatches = 100);
+
+    // counts the photons on the export surfaces instead of storing them
+    void setTally(PhotonsTally* tally) {m_tally = tally;}
+
     typedef void result_type;
 
-    void operator()(ulong nRays);
+    void operator()(const Batch& batch);
 
 private:
     bool NewPrimitiveRay(Ray* ray, Random& rand);
 
     InstanceNode* m_instanceLayout;
+    std::shared_ptr<SceneBVH> m_scene;
     InstanceNode* m_instanceSun;
     SunAperture* m_sunAperture;
     SunShape* m_sunShape;
     Transform m_sunTransform;
     AirTransmission* m_air;
     Random* m_rand;
-    QMutex* m_mutexRand;
+    ulong m_seed;
     PhotonsBuffer* m_photonBuffer;
-    QMutex* m_mutexPhotonsBuffer;
-    QVector<InstanceNode*> m_exportSurfaceList;
-
-    const std::vector< QPair<int, int> >&  m_sunCells;
+    PhotonsTally* m_tally;
+    InstanceSet m_exportSurfaces;
 };
@@ -0,0 +1,191 @@
+#include "SceneBVH.h"
+
+#include "kernel/material/MaterialTransparent.h"
+#include "kernel/profiles/ProfileRT.h"
+#include "kernel/run/InstanceNode.h"
+#include "kernel/scene/TArrayKit.h"
+#include "kernel/scene/TSeparatorKit.h"
+#include "kernel/scene/TShapeKit.h"
+#include "kernel/shape/DifferentialGeometry.h"
+#include "kernel/shape/ShapeRT.h"
+
+
+SceneBVH::SceneBVH(InstanceNode* instanceRoot)
+{
+    if (instanceRoot) collectShapes(instanceRoot);
+
+    std::vector<Box3D> boxes;
+    boxes.reserve(m_shapes.size() + m_copies.size());
+    for (const SceneShape& s : m_shapes)
+        boxes.push_back(s.box);
+    for (const SceneCopy& c : m_copies)
+        boxes.push_back(c.box);
+    m_bvh.build(boxes);
+}
+
+/**
+ * Finds the nearest shape along \a rayIn and computes the reflected ray \a rayOut.
+ * Same conventions as InstanceNode::intersect.
+ **/
+bool SceneBVH::intersect(const Ray& rayIn, Random& rand, bool& isFront, InstanceNode*& instance, Ray& rayOut) const
+{
+    Primitive hit = {0, 0};
+    DifferentialGeometry dg;
+
+    auto f = [&](int index, const Ray& ray) {
+        return intersectPrimitive(index, ray, dg, hit);
+    };
+
+    if (!m_bvh.intersect(rayIn, f)) return false;
+
+    isFront = dg.isFront;
+    instance = hit.copy ? hit.copy->instance : hit.shape->instance;
+    return reflect(hit, dg, rayIn, rand, rayOut);
+}
+
+/**
+ * Checks if any shape is hit along \a ray, the traversal stops at the first hit.
+ * For shadows and blocking, no differential geometry is computed.
+ **/
+bool SceneBVH::occluded(const Ray& ray) const
+{
+    auto f = [this](int index, const Ray& ray) {
+        return occludedPrimitive(index, ray);
+    };
+    return m_bvh.intersectP(ray, f);
+}
+
+// on hit decreases ray.tMax and sets dg in local frame of shape
+bool SceneBVH::intersectPrimitive(int index, const Ray& ray, DifferentialGeometry& dg, Primitive& p) const
+{
+    int nShapes = int(m_shapes.size());
+    if (index < nShapes) {
+        const SceneShape& s = m_shapes[index];
+        if (!intersectShape(s, ray, dg)) return false;
+        p = {&s, 0};
+        return true;
+    }
+
+    const SceneCopy& c = m_copies[index - nShapes];
+    if (!c.box.intersect(ray)) return false;
+    Ray rayChild = c.transform.transformInverse(ray);
+    const SceneShape* s = m_arrays[c.array]->intersectShapes(rayChild, dg);
+    if (!s) return false;
+    ray.tMax = rayChild.tMax; // tMax mutable
+    p = {s, &c};
+    return true;
+}
+
+// nearest shape without copies, ray in frame of this scene
+const SceneShape* SceneBVH::intersectShapes(const Ray& ray, DifferentialGeometry& dg) const
+{
+    const SceneShape* shapeHit = 0;
+    int nShapes = int(m_shapes.size());
+    auto f = [&](int index, const Ray& r) {
+        if (index >= nShapes) return false;
+        const SceneShape& s = m_shapes[index];
+        if (!intersectShape(s, r, dg)) return false;
+        shapeHit = &s;
+        return true;
+    };
+    m_bvh.intersect(ray, f);
+    return shapeHit;
+}
+
+// on hit decreases ray.tMax and sets dg in local frame
+bool SceneBVH::intersectShape(const SceneShape& s, const Ray& ray, DifferentialGeometry& dg) const
+{
+    if (!s.box.intersect(ray)) return false;
+
+    Ray rayLocal = s.transform.transformInverse(ray);
+    double tHit = 0.;
+    DifferentialGeometry dgHit;
+    if (!s.shape->intersect(rayLocal, &tHit, &dgHit, s.profile)) return false;
+    ray.tMax = tHit; // tMax mutable
+    dg = dgHit;
+    return true;
+}
+
+bool SceneBVH::occludedPrimitive(int index, const Ray& ray) const
+{
+    int nShapes = int(m_shapes.size());
+    if (index < nShapes) {
+        const SceneShape& s = m_shapes[index];
+        if (!s.box.intersect(ray)) return false;
+        Ray rayLocal = s.transform.transformInverse(ray);
+        return s.shape->intersectP(rayLocal, s.profile);
+    }
+
+    const SceneCopy& c = m_copies[index - nShapes];
+    if (!c.box.intersect(ray)) return false;
+    Ray rayChild = c.transform.transformInverse(ray);
+    const SceneBVH& child = *m_arrays[c.array];
+    auto f = [&](int i, const Ray& r) {
+        return i < int(child.m_shapes.size()) && child.occludedPrimitive(i, r);
+    };
+    return child.m_bvh.intersectP(rayChild, f);
+}
+
+bool SceneBVH::reflect(const Primitive& p, DifferentialGeometry& dg, const Ray& rayIn, Random& rand, Ray& rayOut) const
+{
+    Transform transform = p.copy ? p.copy->transform*p.shape->transform : p.shape->transform;
+    dg.point = transform.transformPoint(dg.point);
+    dg.dpdu = transform.transformVector(dg.dpdu);
+    dg.dpdv = transform.transformVector(dg.dpdv);
+    dg.normal = transform.transformNormal(dg.normal);
+
+    return p.shape->material->OutputRay(rayIn, dg, rand, rayOut);
+}
+
+void SceneBVH::collectShapes(InstanceNode* instance)
+{
+    SoNode* node = instance->getNode();
+    if (node->getTypeId() == TShapeKit::getClassTypeId())
+    {
+        TShapeKit* kit = (TShapeKit*) node;
+
+        MaterialRT* material = (MaterialRT*) kit->materialRT.getValue();
+        if (!material) return;
+        if (material->getTypeId() == MaterialTransparent::getClassTypeId()) return;
+        ShapeRT* shape = (ShapeRT*) kit->shapeRT.getValue();
+        if (!shape) return;
+
+        SceneShape s;
+        s.shape = shape;
+        s.profile = (ProfileRT*) kit->profileRT.getValue();
+        s.material = material;
+        s.transform = instance->getTransform();
+        s.box = instance->getBox();
+        s.instance = instance;
+        m_shapes.push_back(s);
+    }
+    else if (node->getTypeId() == TSeparatorKit::getClassTypeId())
+    {
+        for (InstanceNode* child : instance->children)
+            collectShapes(child);
+    }
+    else if (node->getTypeId() == TArrayKit::getClassTypeId())
+    {
+        if (instance->children.isEmpty()) return;
+        // children are in the frame of the array, see InstanceNode::updateTree
+        auto child = std::make_shared<SceneBVH>(instance->children[0]);
+        if (child->m_shapes.empty()) return;
+        Box3D box = child->m_bvh.box();
+
+        int array = int(m_arrays.size());
+        m_arrays.push_back(child);
+
+        TArrayKit* kit = (TArrayKit*) node;
+        int nCopies = kit->positions.getNum();
+        m_copies.reserve(m_copies.size() + nCopies);
+        for (int n = 0; n < nCopies; ++n)
+        {
+            SceneCopy c;
+            c.array = array;
+            c.transform = instance->getCopyTransform(n);
+            c.box = c.transform(box);
+            c.instance = instance;
+            m_copies.push_back(c);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <memory>
+#include <vector>
+
+#include "libraries/math/3D/BVH.h"
+#include "libraries/math/3D/Ray.h"
+#include "libraries/math/3D/Transform.h"
+
+struct DifferentialGeometry;
+class InstanceNode;
+class MaterialRT;
+class ProfileRT;
+class Random;
+class ShapeRT;
+
+
+//! SceneShape is a plain copy of a shape instance for ray tracing.
+struct SceneShape
+{
+    const ShapeRT* shape;
+    ProfileRT* profile;
+    const MaterialRT* material;
+    Transform transform; // from object to world
+    Box3D box; // in world frame
+    InstanceNode* instance;
+};
+
+
+//! SceneCopy is a copy of a TArrayKit child, the child is compiled once for all copies.
+struct SceneCopy
+{
+    int array; // index of compiled child
+    Transform transform; // from child to world
+    Box3D box; // in world frame
+    InstanceNode* instance; // of TArrayKit
+};
+
+
+//!  SceneBVH class is a compiled snapshot of a scene for ray tracing.
+/*! The shapes of the TShapeKit instances are copied with their world boxes and transforms from InstanceNode::updateTree
+ * into a contiguous array with a flat acceleration structure over it.
+ * Tracing does not access the scene graph, the parameters of the nodes are read from their plain members.
+ * Call updateTree before constructing, the snapshot is not updated with the scene.
+ * The copies of a TArrayKit refer to a shared SceneBVH of its child (two levels),
+ * a hit on a copy is reported for the instance of the array.
+ */
+
+class TONATIUH_KERNEL SceneBVH
+{
+public:
+    SceneBVH(InstanceNode* instanceRoot);
+
+    bool intersect(const Ray& rayIn, Random& rand, bool& isFront, InstanceNode*& instance, Ray& rayOut) const;
+
+    // any hit, without differential geometry
+    bool occluded(const Ray& ray) const;
+
+    const std::vector<SceneShape>& getShapes() const {return m_shapes;}
+    const std::vector<SceneCopy>& getCopies() const {return m_copies;}
+
+private:
+    // nearest primitive of the top level, shape or copy
+    struct Primitive
+    {
+        const SceneShape* shape;
+        const SceneCopy* copy;
+    };
+
+    void collectShapes(InstanceNode* instance);
+    bool intersectPrimitive(int index, const Ray& ray, DifferentialGeometry& dg, Primitive& p) const;
+    const SceneShape* intersectShapes(const Ray& ray, DifferentialGeometry& dg) const;
+    bool intersectShape(const SceneShape& s, const Ray& ray, DifferentialGeometry& dg) const;
+    bool occludedPrimitive(int index, const Ray& ray) const;
+    bool reflect(const Primitive& p, DifferentialGeometry& dg, const Ray& rayIn, Random& rand, Ray& rayOut) const;
+
+    std::vector<SceneShape> m_shapes;
+    std::vector<SceneCopy> m_copies; // after shapes in m_bvh
+    std::vector< std::shared_ptr<const SceneBVH> > m_arrays;
+    BVH m_bvh;
+};
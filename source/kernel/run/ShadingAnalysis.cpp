@@ -0,0 +1,159 @@
+#include "ShadingAnalysis.h"
+
+#include <numeric>
+
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include "kernel/profiles/ProfileRT.h"
+#include "kernel/run/InstanceNode.h"
+#include "kernel/run/SceneBVH.h"
+#include "kernel/scene/TSceneKit.h"
+#include "kernel/scene/TShapeKit.h"
+#include "kernel/shape/ShapeRT.h"
+#include "kernel/sun/SunKit.h"
+#include "kernel/sun/SunPosition.h"
+
+
+ShadingAnalysis::ShadingAnalysis(TSceneKit* scene, InstanceNode* instanceLayout, const QVector<InstanceNode*>& surfaces):
+    m_scene(scene),
+    m_instanceLayout(instanceLayout),
+    m_surfaces(surfaces),
+    m_trackers(scene),
+    m_gridWidth(10),
+    m_gridHeight(10)
+{
+
+}
+
+void ShadingAnalysis::setGrid(int width, int height)
+{
+    m_gridWidth = width;
+    m_gridHeight = height;
+}
+
+bool ShadingAnalysis::run(const QVector<Sample>& samples)
+{
+    m_samples = samples;
+    m_fractions.clear();
+
+    SunKit* sunKit = (SunKit*) m_scene->getPart("world.sun", false);
+    if (!sunKit) return false;
+    SunPosition* sunPosition = (SunPosition*) sunKit->getPart("position", false);
+
+    if (m_surfaces.isEmpty())
+    {
+        m_instanceLayout->updateTree(Transform::Identity);
+        SceneBVH scene(m_instanceLayout);
+        for (const SceneShape& s : scene.getShapes())
+            m_surfaces << s.instance;
+    }
+    if (m_surfaces.isEmpty()) return false;
+
+    for (const Sample& sample : samples)
+    {
+        if (sample.elevation <= 0.) {
+            m_fractions << QVector<double>(); // night
+            continue;
+        }
+
+        sunPosition->azimuth = sample.azimuth;
+        sunPosition->elevation = sample.elevation;
+        m_trackers.update();
+        m_instanceLayout->updateTree(Transform::Identity);
+
+        SceneBVH scene(m_instanceLayout);
+        m_fractions << findFractions(scene, sunPosition->getSunVector());
+    }
+    return true;
+}
+
+QVector<double> ShadingAnalysis::getFractionsMean() const
+{
+    QVector<double> ans(m_surfaces.size(), 0.);
+    double weights = 0.;
+    for (int n = 0; n < m_fractions.size(); ++n)
+    {
+        if (m_fractions[n].isEmpty()) continue;
+        weights += m_samples[n].weight;
+        for (int s = 0; s < ans.size(); ++s)
+            ans[s] += m_samples[n].weight*m_fractions[n][s];
+    }
+    if (weights > 0.)
+        for (double& f : ans) f /= weights;
+    return ans;
+}
+
+/*!
+ * Writes a tab separated table with a row for each sample and the weighted mean.
+ * The cells are empty for the sun below the horizon.
+ */
+void ShadingAnalysis::write(QTextStream& out) const
+{
+    out << "azimuth\televation\tweight";
+    for (InstanceNode* surface : m_surfaces)
+        out << "\t" << surface->getURL();
+    out << "\n";
+
+    for (int n = 0; n < m_fractions.size(); ++n)
+    {
+        const Sample& sample = m_samples[n];
+        out << sample.azimuth << "\t" << sample.elevation << "\t" << sample.weight;
+        if (m_fractions[n].isEmpty())
+            out << QString(m_surfaces.size(), '\t');
+        for (double f : m_fractions[n])
+            out << "\t" << f;
+        out << "\n";
+    }
+
+    out << "mean\t\t";
+    for (double f : getFractionsMean())
+        out << "\t" << f;
+    out << "\n";
+}
+
+QVector<double> ShadingAnalysis::findFractions(const SceneBVH& scene, const vec3d& vSun) const
+{
+    QVector<double> ans(m_surfaces.size());
+    double* fractions = ans.data();
+    QVector<int> indices(m_surfaces.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(indices, [&](int n) {
+        fractions[n] = findFraction(scene, m_surfaces[n], vSun);
+    });
+    return ans;
+}
+
+double ShadingAnalysis::findFraction(const SceneBVH& scene, InstanceNode* instance, const vec3d& vSun) const
+{
+    TShapeKit* kit = (TShapeKit*) instance->getNode();
+    ShapeRT* shape = (ShapeRT*) kit->shapeRT.getValue();
+    ProfileRT* profile = (ProfileRT*) kit->profileRT.getValue();
+    if (!shape || !profile) return 0.;
+
+    const Transform& toWorld = instance->getTransform();
+    double tMin = 1e-6*instance->getBox().size().norm(); // skip the surface itself
+    Box2D box = profile->getBox();
+    double uStep = box.size().x/m_gridWidth;
+    double vStep = box.size().y/m_gridHeight;
+
+    double areaTotal = 0.;
+    double areaShaded = 0.;
+    for (int i = 0; i < m_gridWidth; ++i) {
+        double u = box.min().x + (i + 0.5)*uStep;
+        for (int j = 0; j < m_gridHeight; ++j) {
+            double v = box.min().y + (j + 0.5)*vStep;
+            if (!profile->isInside(u, v)) continue;
+
+            vec3d dpdu = toWorld.transformVector(shape->getDerivativeU(u, v));
+            vec3d dpdv = toWorld.transformVector(shape->getDerivativeV(u, v));
+            double area = cross(dpdu, dpdv).norm();
+            areaTotal += area;
+
+            vec3d point = toWorld.transformPoint(shape->getPoint(u, v));
+            if (scene.occluded(Ray(point, vSun, tMin)))
+                areaShaded += area;
+        }
+    }
+    return areaTotal > 0. ? areaShaded/areaTotal : 0.;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <QVector>
+
+#include "kernel/run/TraceSeries.h"
+#include "kernel/trackers/TrackerBatch.h"
+
+class InstanceNode;
+class QTextStream;
+class SceneBVH;
+class TSceneKit;
+
+
+//! ShadingAnalysis finds the shaded fraction of surfaces for a list of sun positions.
+/*!
+ * For each position the trackers are solved and a SceneBVH is compiled.
+ * From a grid of points on each surface a ray is sent to the sun and only checked with SceneBVH::occluded,
+ * so neither photons nor differential geometry are made.
+ * The fraction is weighted by the area of the points, points outside the profile are skipped.
+ */
+class TONATIUH_KERNEL ShadingAnalysis
+{
+public:
+    typedef TraceSeries::Sample Sample;
+
+    // all shapes if surfaces is empty
+    ShadingAnalysis(TSceneKit* scene, InstanceNode* instanceLayout, const QVector<InstanceNode*>& surfaces);
+
+    void setGrid(int width, int height);
+
+    bool run(const QVector<Sample>& samples);
+
+    // for each sample the shaded fraction of the surfaces, empty for the sun below the horizon
+    const QVector< QVector<double> >& getFractions() const {return m_fractions;}
+    QVector<double> getFractionsMean() const; // over the samples with the sun above the horizon
+    void write(QTextStream& out) const;
+
+private:
+    QVector<double> findFractions(const SceneBVH& scene, const vec3d& vSun) const;
+    double findFraction(const SceneBVH& scene, InstanceNode* instance, const vec3d& vSun) const;
+
+    TSceneKit* m_scene;
+    InstanceNode* m_instanceLayout;
+    QVector<InstanceNode*> m_surfaces;
+    TrackerBatch m_trackers;
+
+    int m_gridWidth;
+    int m_gridHeight;
+
+    QVector<Sample> m_samples;
+    QVector< QVector<double> > m_fractions;
+};
@@ -0,0 +1,179 @@
+#include "TraceSeries.h"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include "kernel/air/AirTransmission.h"
+#include "kernel/air/AirVacuum.h"
+#include "kernel/node/TonatiuhFunctions.h"
+#include "kernel/photons/PhotonsTally.h"
+#include "kernel/run/InstanceNode.h"
+#include "kernel/run/RayTracer.h"
+#include "kernel/run/SceneBVH.h"
+#include "kernel/scene/TSceneKit.h"
+#include "kernel/sun/SunAperture.h"
+#include "kernel/sun/SunKit.h"
+#include "kernel/sun/SunPosition.h"
+#include "kernel/sun/SunShape.h"
+
+
+/*!
+ * Reads lines with azimuth, elevation and optional weight (1 by default),
+ * separated by spaces, tabs or commas. Empty lines, comments (#) and headers are skipped.
+ */
+QVector<TraceSeries::Sample> TraceSeries::readSamples(const QString& fileName, QString& message)
+{
+    QVector<Sample> samples;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        message = QString("Cannot open file %1.").arg(fileName);
+        return samples;
+    }
+
+    QTextStream in(&file);
+    QRegularExpression separators("[\\s,;]+");
+    while (!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        QStringList list = line.split(separators, Qt::SkipEmptyParts);
+        if (list.size() < 2) continue;
+
+        bool okA, okE, okW = true;
+        Sample s;
+        s.azimuth = list[0].toDouble(&okA);
+        s.elevation = list[1].toDouble(&okE);
+        s.weight = list.size() > 2 ? list[2].toDouble(&okW) : 1.;
+        if (okA && okE && okW) samples << s;
+    }
+
+    if (samples.isEmpty())
+        message = QString("No sun positions in %1.").arg(fileName);
+    return samples;
+}
+
+TraceSeries::TraceSeries(TSceneKit* scene, InstanceNode* instanceLayout, const QVector<InstanceNode*>& surfaces):
+    m_scene(scene),
+    m_instanceLayout(instanceLayout),
+    m_surfaces(surfaces),
+    m_trackers(scene),
+    m_nRays(1'000'000),
+    m_gridWidth(200),
+    m_gridHeight(200),
+    m_rand(0)
+{
+
+}
+
+void TraceSeries::setGrid(int width, int height)
+{
+    m_gridWidth = width;
+    m_gridHeight = height;
+}
+
+bool TraceSeries::run(const QVector<Sample>& samples)
+{
+    m_samples = samples;
+    m_powers.clear();
+    if (!m_rand || m_nRays == 0) return false;
+
+    if (m_surfaces.isEmpty())
+    {
+        m_instanceLayout->updateTree(Transform::Identity);
+        SceneBVH scene(m_instanceLayout);
+        for (const SceneShape& s : scene.getShapes())
+            m_surfaces << s.instance;
+    }
+    if (m_surfaces.isEmpty()) return false;
+
+    for (const Sample& sample : samples)
+    {
+        QVector<double> powers(m_surfaces.size() + 1, 0.);
+        if (sample.elevation > 0. && !trace(sample, powers))
+            return false;
+        m_powers << powers;
+    }
+    return true;
+}
+
+QVector<double> TraceSeries::getPowersTotal() const
+{
+    QVector<double> ans(m_surfaces.size() + 1, 0.);
+    for (int n = 0; n < m_powers.size(); ++n)
+        for (int s = 0; s < ans.size(); ++s)
+            ans[s] += m_samples[n].weight*m_powers[n][s];
+    return ans;
+}
+
+/*!
+ * Writes a tab separated table with a row for each sample and the weighted total.
+ */
+void TraceSeries::write(QTextStream& out) const
+{
+    out << "azimuth\televation\tweight\taperture";
+    for (InstanceNode* surface : m_surfaces)
+        out << "\t" << surface->getURL();
+    out << "\n";
+
+    for (int n = 0; n < m_powers.size(); ++n)
+    {
+        const Sample& sample = m_samples[n];
+        out << sample.azimuth << "\t" << sample.elevation << "\t" << sample.weight;
+        for (double p : m_powers[n])
+            out << "\t" << p;
+        out << "\n";
+    }
+
+    out << "total\t\t";
+    for (double p : getPowersTotal())
+        out << "\t" << p;
+    out << "\n";
+}
+
+bool TraceSeries::trace(const Sample& sample, QVector<double>& powers)
+{
+    SunKit* sunKit = (SunKit*) m_scene->getPart("world.sun", false);
+    if (!sunKit) return false;
+    SunPosition* sunPosition = (SunPosition*) sunKit->getPart("position", false);
+    SunShape* sunShape = (SunShape*) sunKit->getPart("shape", false);
+    SunAperture* sunAperture = (SunAperture*) sunKit->getPart("aperture", false);
+
+    sunPosition->azimuth = sample.azimuth;
+    sunPosition->elevation = sample.elevation;
+    m_trackers.update();
+
+    // static geometry is kept, only transforms and boxes are updated
+    m_instanceLayout->updateTree(Transform::Identity);
+    sunKit->setBox(m_instanceLayout->getBox());
+    if (!sunKit->findTexture(m_gridWidth, m_gridHeight, m_instanceLayout)) return false;
+
+    InstanceNode instanceSun(sunKit);
+    instanceSun.setTransform(tgf::makeTransform(sunKit->m_transform));
+
+    AirTransmission* air = (AirTransmission*) m_scene->getPart("world.air.transmission", false);
+    if (air && air->getTypeId() == AirVacuum::getClassTypeId()) air = 0;
+
+    PhotonsTally tally(m_surfaces);
+    RayTracer rayTracer(
+        m_instanceLayout,
+        &instanceSun, sunAperture, sunShape, air,
+        m_rand, 0, m_surfaces
+    );
+    rayTracer.setTally(&tally);
+
+    QVector<RayTracer::Batch> batches = RayTracer::makeBatches(m_nRays);
+    QtConcurrent::blockingMap(batches, rayTracer);
+
+    double powerAperture = sunAperture->getArea()*sunPosition->irradiance.getValue();
+    double powerPhoton = powerAperture/m_nRays;
+    powers[0] = powerAperture;
+    for (int s = 0; s < m_surfaces.size(); ++s)
+    {
+        InstanceNode* surface = m_surfaces[s];
+        ulong hits = tally.getHits(surface, true) + tally.getHits(surface, false);
+        powers[s + 1] = hits*powerPhoton;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <QVector>
+
+#include "kernel/trackers/TrackerBatch.h"
+
+class InstanceNode;
+class QTextStream;
+class Random;
+class TSceneKit;
+
+
+//! TraceSeries traces a scene for a list of sun positions.
+/*!
+ * The instance tree and the trackers are collected once and reused for all positions.
+ * For each position the trackers are solved, the transforms and the sun aperture are updated
+ * and the rays are traced in tally mode on the shared thread pool.
+ * The result is the power on each surface for each position and the weighted total.
+ */
+class TONATIUH_KERNEL TraceSeries
+{
+public:
+    struct Sample
+    {
+        double azimuth; // in degrees
+        double elevation;
+        double weight;
+    };
+    static QVector<Sample> readSamples(const QString& fileName, QString& message);
+
+    // all shapes if surfaces is empty
+    TraceSeries(TSceneKit* scene, InstanceNode* instanceLayout, const QVector<InstanceNode*>& surfaces);
+
+    void setRays(ulong nRays) {m_nRays = nRays;}
+    void setGrid(int width, int height);
+    void setRandom(Random* rand) {m_rand = rand;}
+
+    bool run(const QVector<Sample>& samples);
+
+    // in W, for each sample the aperture and then the surfaces
+    const QVector< QVector<double> >& getPowers() const {return m_powers;}
+    QVector<double> getPowersTotal() const;
+    void write(QTextStream& out) const;
+
+private:
+    bool trace(const Sample& sample, QVector<double>& powers);
+
+    TSceneKit* m_scene;
+    InstanceNode* m_instanceLayout;
+    QVector<InstanceNode*> m_surfaces;
+    TrackerBatch m_trackers;
+
+    ulong m_nRays;
+    int m_gridWidth;
+    int m_gridHeight;
+    Random* m_rand;
+
+    QVector<Sample> m_samples;
+    QVector< QVector<double> > m_powers;
+};
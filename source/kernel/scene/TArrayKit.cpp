@@ -42,6 +42,7 @@ TArrayKit::TArrayKit()
     fieldData->addField(this, "positions", &positions);
 
     SO_NODE_ADD_FIELD(nMax, (5));
+    SO_NODE_ADD_FIELD(child, (0));
 
     m_vs_matrixViewModel = 0;
 
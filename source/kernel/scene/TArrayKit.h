@@ -4,6 +4,7 @@
 #include <Inventor/nodekits/SoBaseKit.h>
 #include <Inventor/fields/SoMFVec3f.h>
 #include <Inventor/fields/SoSFInt32.h>
+#include <Inventor/fields/SoSFNode.h>
 #include <Inventor/nodes/SoSubNode.h>
 #include <Inventor/nodes/SoShape.h>
 #include <Inventor/nodes/SoSeparator.h>
@@ -16,6 +17,14 @@ class SoShaderParameterMatrix;
 class SoShaderParameter1i;
 class SoIndexedFaceSetT;
 
+//! TArrayKit places copies of a shared child at positions.
+/*!
+ * The child (TShapeKit or TSeparatorKit) is translated to each of the positions in the frame of the array.
+ * For ray tracing the child is compiled once and the copies only keep their transforms,
+ * arrays inside the child are not traced.
+ * The copies share the orientation of the child: trackers inside it are not solved per copy,
+ * TrackerBatch skips them (see TrackerBatch::ignored).
+ */
 class TONATIUH_KERNEL TArrayKit: public SoNode
 {
 //    SO_KIT_HEADER(TArrayKit);
@@ -27,6 +36,7 @@ public:
 
     SoMFVec3f positions;
     SoSFInt32 nMax;
+    SoSFNode child; // shared by the copies
 
     TSeparatorKit* m_parent;
 
@@ -1,13 +1,19 @@
 #include "TSceneKit.h"
 
+#include <Inventor/SoDB.h>
+#include <Inventor/SoInput.h>
 #include <Inventor/nodes/SoTransform.h>
 #include <Inventor/nodes/SoGroup.h>
+#include <Inventor/nodes/SoSeparator.h>
+
+#include <QString>
 
 
 #include "libraries/math/gcf.h"
 #include "libraries/math/3D/Transform.h"
 #include "libraries/math/3D/vec3d.h"
 
+#include "kernel/trackers/TrackerBatch.h"
 #include "kernel/trackers/TrackerKit.h"
 #include "kernel/air/AirTransmission.h"
 #include "kernel/sun/SunShapePillbox.h"
@@ -63,16 +69,65 @@ TSceneKit::TSceneKit()
 //    setCameraNumber(0);
 }
 
+/*!
+ * Reads the scene from \a fileName without creating any views.
+ * Returns 0 and sets \a message if the file cannot be read.
+ */
+TSceneKit* TSceneKit::readFile(const QString& fileName, QString& message)
+{
+    SoInput input;
+
+    if (!input.openFile(fileName.toLatin1().data()))
+    {
+        message = QString("Cannot open file %1.").arg(fileName);
+        return 0;
+    }
+
+    if (!input.isValidFile())
+    {
+        message = QString("Error reading file %1.").arg(fileName);
+        return 0;
+    }
+
+    SoSeparator* separator = SoDB::readAll(&input);
+    input.closeFile();
+
+    if (!separator)
+    {
+        message = QString("Error reading file %1.").arg(fileName);
+        return 0;
+    }
+
+    TSceneKit* scene = dynamic_cast<TSceneKit*>(separator->getChild(0));
+    if (!scene)
+    {
+        message = QString("File %1 does not contain a scene.").arg(fileName);
+        return 0;
+    }
+
+    QString version = scene->version.getValue().getString();
+    if (version != "2020")
+    {
+        message = QString("Version %1 is not compatible.").arg(version);
+        return 0;
+    }
+
+    return scene;
+}
+
 TSeparatorKit* TSceneKit::getLayout()
 {
     return (TSeparatorKit*) getPart("group", false);
 }
 
+/*!
+ * Updates all trackers transform for the current sun angles.
+ * Use TrackerBatch directly to update the trackers repeatedly.
+ */
 void TSceneKit::updateTrackers()
 {
-    SunPosition* sp = (SunPosition*) getPart("world.sun.position", false);
-    vec3d vSun = sp->getSunVector();
-    updateTrackers(getLayout(), Transform::Identity, vSun);
+    TrackerBatch batch(this);
+    batch.update();
 }
 
 void TSceneKit::updateParents(TSeparatorKit* parent)
@@ -98,29 +153,3 @@ TSceneKit::~TSceneKit()
 
 }
 
-/*!
- * Updates all trackers transform for the current sun angles.
- */
-void TSceneKit::updateTrackers(TSeparatorKit* parent, Transform toGlobal, const vec3d& vSun)
-{
-    SunPosition* sp = (SunPosition*) getPart("world.sun.position", false);
-    if (!sp->trackable.getValue()) return;
-
-    TTransform* tParent = (TTransform*) parent->getPart("transform", true);
-    Transform t = toGlobal*tgf::makeTransform(tParent);
-
-    SoGroup* nodes = (SoGroup*) parent->getPart("group", false);
-    if (!nodes) return;
-
-    for (int n = 0; n < nodes->getNumChildren(); ++n)
-    {
-        SoNode* node = nodes->getChild(n);
-        if (TSeparatorKit* child = dynamic_cast<TSeparatorKit*>(node))
-            updateTrackers(child, t, vSun);
-        else if (TrackerKit* tracker = dynamic_cast<TrackerKit*>(node)) {
-            tracker->update(parent, t, vSun);
-//            return;  // for multitrackers
-        }
-    }
-}
-
@@ -26,6 +26,8 @@ public:
     static void initClass();
     TSceneKit();
 
+    static TSceneKit* readFile(const QString& fileName, QString& message);
+
     TSeparatorKit* getLayout();
 
     void updateTrackers();
@@ -35,5 +37,4 @@ public:
 
 protected:
     ~TSceneKit();
-    void updateTrackers(TSeparatorKit* parent, Transform t, const vec3d& vSun);
 };
@@ -45,6 +45,9 @@ TShapeKit::TShapeKit()
     materialRT = new MaterialAbsorber;
     material = new MaterialGL;
 
+    m_meshPending = false;
+    m_meshVersion = 0;
+
     m_shapeKit = new SoShapeKit;
 //    m_shapeKit->setSearchingChildren(TRUE);
 //    m_shapeKit->ref();
@@ -99,6 +102,8 @@ void TShapeKit::onSensor(void* data, SoSensor*)
 //        kit->m_shapeKit->setPart("material", kit->material.getValue());
     }
 
+    kit->m_meshPending = false;
+    kit->m_meshVersion++;
     ShapeRT* shape = (ShapeRT*) kit->shapeRT.getValue();
     shape->updateShapeGL(kit);
 }
@@ -116,9 +121,21 @@ void TShapeKit::onSensorShape(void* data, SoSensor*)
 //    kit->enableNotify(FALSE);
 //    kit->profileRT = shape->getDefaultProfile();
 //    kit->enableNotify(TRUE);
+    kit->m_meshPending = false;
+    kit->m_meshVersion++;
     shape->updateShapeGL(kit);
 }
 
+void TShapeKit::GLRender(SoGLRenderAction* action)
+{
+    if (m_meshPending) {
+        m_meshPending = false;
+        ShapeRT* shape = (ShapeRT*) shapeRT.getValue();
+        shape->makePolygonMesh(this);
+    }
+    SoBaseKit::GLRender(action);
+}
+
 void TShapeKit::setDefaultOnNonWritingFields()
 {
     topSeparator.setDefault(TRUE);
@@ -131,11 +148,20 @@ SbBool TShapeKit::setUpConnections(SbBool onoff, SbBool doitalways)
     return SoBaseKit::setUpConnections(onoff, doitalways);
 }
 
+/*!
+ * Reads the fields without scheduling the sensors and updates the shape once.
+ */
 SbBool TShapeKit::readInstance(SoInput* in, unsigned short flags)
 {
-//    shapeRT.enableNotify(FALSE);
+    SbBool notifyShape = shapeRT.enableNotify(FALSE);
+    SbBool notifyProfile = profileRT.enableNotify(FALSE);
+    SbBool notifyMaterial = material.enableNotify(FALSE);
     SbBool ans = SoBaseKit::readInstance(in, flags);
-//    shapeRT.enableNotify(TRUE);
+    shapeRT.enableNotify(notifyShape);
+    profileRT.enableNotify(notifyProfile);
+    material.enableNotify(notifyMaterial);
+
+    if (ans) onSensor(this, 0);
     return ans;
 }
 
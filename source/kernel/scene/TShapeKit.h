@@ -5,6 +5,7 @@
 #include <Inventor/nodekits/SoShapeKit.h>
 
 class SoFieldSensor;
+class SoGLRenderAction;
 class SoSensor;
 
 
@@ -25,6 +26,10 @@ public:
     SoSFNode material;
 
     SoShapeKit* m_shapeKit;
+    bool m_meshPending; // polygon mesh made at first rendering
+    int m_meshVersion; // changed with each update of m_shapeKit
+
+    void GLRender(SoGLRenderAction* action);
 
 protected:
      ~TShapeKit();
@@ -0,0 +1,102 @@
+#include "PolygonMeshCache.h"
+
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include <Inventor/fields/SoField.h>
+#include <Inventor/lists/SoFieldList.h>
+
+#include "kernel/shape/ShapeRT.h"
+#include "libraries/DistMesh/PolygonMesh.h"
+
+QHash<QString, PolygonMeshCache::Entry> PolygonMeshCache::s_meshes;
+quint64 PolygonMeshCache::s_time = 0;
+int PolygonMeshCache::s_maxSize = 256;
+
+
+struct MeshDensityShape: public MeshDensity
+{
+    virtual double operator()(double u, double v) {return shape->getStepHint(u, v);}
+    ShapeRT* shape;
+};
+
+/*!
+ * Returns the mesh of \a polygon for \a shape, starts meshing if it is not in the cache.
+ */
+QFuture<PolygonMeshCache::Mesh> PolygonMeshCache::find(ShapeRT* shape, const QPolygonF& polygon)
+{
+    QString key = makeKey(shape, polygon);
+    auto it = s_meshes.find(key);
+    if (it != s_meshes.end()) {
+        it->used = ++s_time;
+        return it->mesh;
+    }
+
+    ShapeRT* shapeCopy = (ShapeRT*) shape->copy();
+    shapeCopy->ref();
+
+    QFuture<Mesh> future = QtConcurrent::run([shapeCopy, polygon]() -> Mesh {
+        MeshDensityShape mds;
+        mds.shape = shapeCopy;
+        std::shared_ptr<PolygonMesh> mesh = std::make_shared<PolygonMesh>(polygon);
+        if (!mesh->makeMesh(1e8, mds)) return Mesh();
+        return mesh;
+    });
+
+    // release the copy in the main thread
+    QFutureWatcher<Mesh>* watcher = new QFutureWatcher<Mesh>;
+    QObject::connect(watcher, &QFutureWatcher<Mesh>::finished, [watcher, shapeCopy]() {
+        shapeCopy->unref();
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+
+    s_meshes[key] = Entry{future, ++s_time};
+    evict();
+    return future;
+}
+
+void PolygonMeshCache::clear()
+{
+    s_meshes.clear();
+}
+
+void PolygonMeshCache::setMaxSize(int size)
+{
+    s_maxSize = size;
+    evict();
+}
+
+// meshes in progress are kept
+void PolygonMeshCache::evict()
+{
+    while (s_meshes.size() > s_maxSize) {
+        auto oldest = s_meshes.end();
+        for (auto it = s_meshes.begin(); it != s_meshes.end(); ++it) {
+            if (!it->mesh.isFinished()) continue;
+            if (oldest == s_meshes.end() || it->used < oldest->used)
+                oldest = it;
+        }
+        if (oldest == s_meshes.end()) return;
+        s_meshes.erase(oldest);
+    }
+}
+
+QString PolygonMeshCache::makeKey(ShapeRT* shape, const QPolygonF& polygon)
+{
+    QString ans = shape->getTypeId().getName().getString();
+
+    SoFieldList fields;
+    shape->getFields(fields);
+    for (int n = 0; n < fields.getLength(); ++n) {
+        SbString value;
+        fields[n]->get(value);
+        ans += ";";
+        ans += value.getString();
+    }
+
+    ans += ";";
+    for (const QPointF& p : polygon)
+        ans += QString(" %1 %2").arg(p.x(), 0, 'g', 17).arg(p.y(), 0, 'g', 17);
+    return ans;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <memory>
+
+#include <QFuture>
+#include <QHash>
+#include <QPolygonF>
+
+class PolygonMesh;
+class ShapeRT;
+
+
+//! PolygonMeshCache shares the meshes of polygon profiles between shapes.
+/*!
+ * A mesh is keyed by the shape type, the values of its fields and the vertices of the polygon.
+ * It is made once on a worker thread with a copy of the shape for the step hints,
+ * so the shape can be edited or deleted meanwhile.
+ * At most maxSize() meshes are kept, the least recently used finished ones are dropped first.
+ * The cache is used from the main thread only.
+ */
+class TONATIUH_KERNEL PolygonMeshCache
+{
+public:
+    typedef std::shared_ptr<const PolygonMesh> Mesh; // null if meshing failed
+
+    static QFuture<Mesh> find(ShapeRT* shape, const QPolygonF& polygon);
+    static void clear();
+
+    static int maxSize() {return s_maxSize;}
+    static void setMaxSize(int size);
+
+private:
+    struct Entry
+    {
+        QFuture<Mesh> mesh;
+        quint64 used; // time of last use
+    };
+
+    static QString makeKey(ShapeRT* shape, const QPolygonF& polygon);
+    static void evict();
+
+    static QHash<QString, Entry> s_meshes;
+    static quint64 s_time;
+    static int s_maxSize;
+};
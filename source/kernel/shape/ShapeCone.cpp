@@ -20,6 +20,8 @@ ShapeCone::ShapeCone()
     SO_NODE_CONSTRUCTOR(ShapeCone);
 
     SO_NODE_ADD_FIELD( dr, (-1.) );
+
+    attachSensor();
 }
 
 vec3d ShapeCone::getPoint(double u, double v) const
@@ -32,7 +34,7 @@ vec3d ShapeCone::getPoint(double u, double v) const
 // [x, y, -(1 + dr*z)dr]
 vec3d ShapeCone::getNormal(double u, double v) const
 {
-    double drV = dr.getValue();
+    double drV = m_dr;
     double r = 1. + drV*v;
     r = r >= 0. ? 1. : -1;
     return vec3d(r*cos(u), r*sin(u), -r*drV).normalized();
@@ -55,7 +57,7 @@ Box3D ShapeCone::getBox(ProfileRT* aperture) const
     Box2D box = aperture->getBox();
     double zMin = box.min().y;
     double zMax = box.max().y;
-    double drV = dr.getValue();
+    double drV = m_dr;
     double rMin = std::abs(1. + drV*zMin);
     double rMax = std::abs(1. + drV*zMax);
     if (rMin > rMax) std::swap(rMin, rMax);
@@ -70,7 +72,7 @@ bool ShapeCone::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg
 {
     const vec3d& rayO = ray.origin;
     const vec3d& rayD = ray.direction();
-    double drV = dr.getValue();
+    double drV = m_dr;
 
     // |rxy|^2 = |1 + dr*z|^2, r = r0 + t*d
     double rz = 1. + drV*rayO.z;
@@ -123,3 +125,8 @@ void ShapeCone::updateShapeGL(TShapeKit* parent)
 
     makeQuadMesh(parent, QSize(rows, 2));
 }
+
+void ShapeCone::updateCache()
+{
+    m_dr = dr.getValue();
+}
@@ -25,4 +25,9 @@ public:
     SoSFDouble dr;
 
     NAME_ICON_FUNCTIONS("Cone", ":/shape/ShapeCone.png")
+
+protected:
+    double m_dr;
+
+    void updateCache();
 };
@@ -4,7 +4,6 @@
 #include <Inventor/nodes/SoNormal.h>
 #include <Inventor/nodes/SoQuadMesh.h>
 #include <Inventor/nodes/SoIndexedFaceSet.h>
-
 #include "kernel/profiles/ProfileBox.h"
 #include "kernel/scene/TShapeKit.h"
 #include "kernel/shape/DifferentialGeometry.h"
@@ -31,6 +30,8 @@ ShapeCylinder::ShapeCylinder()
 
     SO_NODE_SET_SF_ENUM_TYPE(caps, Caps);
     SO_NODE_ADD_FIELD(caps, (none) );
+
+    attachSensor();
 }
 
 ProfileRT* ShapeCylinder::getDefaultProfile() const
@@ -196,9 +197,9 @@ bool ShapeCylinder::intersect(const Ray& ray, double* tHit, DifferentialGeometry
         {ans = true; break;}
     }
 
-    if (caps.getValue() != Caps::none) {
+    if (m_caps != Caps::none) {
         Box2D box2d = profile->getBox();
-        if (caps.getValue() & Caps::top) {
+        if (m_caps & Caps::top) {
             double t = (box2d.max().y - rayO.z)*ray.invDirection().z;
             if (t < ray.tMin + 1e-5 || t > ray.tMax || (ans && t > *tHit)) {}
             else {
@@ -219,7 +220,7 @@ bool ShapeCylinder::intersect(const Ray& ray, double* tHit, DifferentialGeometry
                 }
             }
         }
-        if (caps.getValue() & Caps::bottom) {
+        if (m_caps & Caps::bottom) {
             double t = (box2d.min().y - rayO.z)*ray.invDirection().z;
             if (t < ray.tMin + 1e-5 || t > ray.tMax || (ans && t > *tHit)) {}
             else {
@@ -244,3 +245,8 @@ bool ShapeCylinder::intersect(const Ray& ray, double* tHit, DifferentialGeometry
 
     return ans;
 }
+
+void ShapeCylinder::updateCache()
+{
+    m_caps = caps.getValue();
+}
@@ -35,4 +35,9 @@ public:
     SoSFEnum caps;
 
     NAME_ICON_FUNCTIONS("Cylinder", ":/shape/ShapeCylinder.png")
+
+protected:
+    int m_caps;
+
+    void updateCache();
 };
@@ -21,6 +21,8 @@ ShapeParabolic::ShapeParabolic()
 
     SO_NODE_ADD_FIELD( fX, (1.) );
     SO_NODE_ADD_FIELD( fY, (1.) );
+
+    attachSensor();
 }
 
 vec3d ShapeParabolic::getPoint(double u, double v) const
@@ -86,14 +88,19 @@ Box3D ShapeParabolic::getBox(ProfileRT* profile) const
     );
 }
 
+QVector<vec3d> ShapeParabolic::getHull(ProfileRT* profile) const
+{
+    return makeHull(profile, QSize(8, 8));
+}
+
 // x^2*gx + y^2*gy = 4z
 // r = r0 + d*t
 bool ShapeParabolic::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const
 {
     const vec3d& rayO = ray.origin;
     const vec3d& rayD = ray.direction();
-    double gX = 1./fX.getValue();
-    double gY = 1./fY.getValue();
+    double gX = m_gX;
+    double gY = m_gY;
 
     double A = pow2(rayD.x)*gX + pow2(rayD.y)*gY;
     double B = 2.*(rayD.x*rayO.x*gX + rayD.y*rayO.y*gY) - 4.*rayD.z;
@@ -126,3 +133,9 @@ bool ShapeParabolic::intersect(const Ray& ray, double* tHit, DifferentialGeometr
     }
     return false;
 }
+
+void ShapeParabolic::updateCache()
+{
+    m_gX = 1./fX.getValue();
+    m_gY = 1./fY.getValue();
+}
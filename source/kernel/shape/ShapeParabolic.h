@@ -15,6 +15,7 @@ public:
     vec3d getNormal(double u, double v) const;
 
     Box3D getBox(ProfileRT* profile) const;
+    QVector<vec3d> getHull(ProfileRT* profile) const;
     double getStepHint(double u, double v) const;
 
     void updateShapeGL(TShapeKit* parent);
@@ -24,4 +25,10 @@ public:
     SoSFDouble fY;
 
     NAME_ICON_FUNCTIONS("Parabolic", ":/shape/ShapeParabolic.png")
+
+protected:
+    double m_gX;
+    double m_gY;
+
+    void updateCache();
 };
@@ -1,5 +1,7 @@
 #include "ShapePlanar.h"
 
+#include <QSize>
+
 #include "kernel/profiles/ProfileRT.h"
 #include "kernel/scene/TShapeKit.h"
 #include "kernel/shape/DifferentialGeometry.h"
@@ -20,6 +22,11 @@ ShapePlanar::ShapePlanar()
     isBuiltIn = TRUE;
 }
 
+QVector<vec3d> ShapePlanar::getHull(ProfileRT* profile) const
+{
+    return makeHull(profile, QSize(2, 2));
+}
+
 void ShapePlanar::updateShapeGL(TShapeKit* parent)
 {
     makeQuadMesh(parent, QSize(2, 2));
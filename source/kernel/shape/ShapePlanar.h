@@ -12,5 +12,6 @@ public:
     ShapePlanar();
 
     NAME_ICON_FUNCTIONS("Planar", ":/shape/ShapePlanar.png")
+    QVector<vec3d> getHull(ProfileRT* profile) const;
     void updateShapeGL(TShapeKit* parent);
 };
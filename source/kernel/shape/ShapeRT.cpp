@@ -1,5 +1,6 @@
 #include "ShapeRT.h"
 
+#include <QFutureWatcher>
 #include <QSize>
 #include <QVector>
 
@@ -7,6 +8,7 @@
 #include <Inventor/nodes/SoNormal.h>
 #include <Inventor/nodes/SoQuadMesh.h>
 #include <Inventor/nodes/SoIndexedFaceSet.h>
+#include <Inventor/nodes/SoIndexedLineSet.h>
 
 #include "kernel/scene/TShapeKit.h"
 #include "kernel/shape/DifferentialGeometry.h"
@@ -16,6 +18,7 @@
 #include "libraries/math/3D/Box3D.h"
 #include "libraries/math/3D/Ray.h"
 #include "kernel/profiles/ProfilePolygon.h"
+#include "kernel/shape/PolygonMeshCache.h"
 #include "libraries/DistMesh/PolygonMesh.h"
 #include "scene/MaterialGL.h"
 
@@ -99,6 +102,40 @@ Box3D ShapeRT::getBox(ProfileRT* profile) const
                 );
 }
 
+QVector<vec3d> ShapeRT::getHull(ProfileRT* profile) const
+{
+    Box3D box = getBox(profile);
+    const vec3d& vA = box.min();
+    const vec3d& vB = box.max();
+    return {
+        vec3d(vA.x, vA.y, vA.z),
+        vec3d(vA.x, vA.y, vB.z),
+        vec3d(vA.x, vB.y, vA.z),
+        vec3d(vA.x, vB.y, vB.z),
+        vec3d(vB.x, vA.y, vA.z),
+        vec3d(vB.x, vA.y, vB.z),
+        vec3d(vB.x, vB.y, vA.z),
+        vec3d(vB.x, vB.y, vB.z)
+    };
+}
+
+/*!
+ * Points of the surface on the mesh of \a profile, for shapes defined by getPoint.
+ * Falls back to the corners of the box if the profile has no mesh.
+ */
+QVector<vec3d> ShapeRT::makeHull(ProfileRT* profile, const QSize& dims) const
+{
+    QSize dimensions = dims;
+    QVector<vec2d> uvs = profile->makeMesh(dimensions);
+    if (uvs.isEmpty()) return ShapeRT::getHull(profile);
+
+    QVector<vec3d> ans;
+    ans.reserve(uvs.size());
+    for (const vec2d& uv : uvs)
+        ans << getPoint(uv.x, uv.y);
+    return ans;
+}
+
 ProfileRT* ShapeRT::getDefaultProfile() const
 {
     ProfileBox* pr = new ProfileBox;
@@ -133,12 +170,6 @@ bool ShapeRT::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg,
     return true;
 }
 
-struct MeshDensityShape: public MeshDensity
-{
-    virtual double operator()(double u, double v) {return shape->getStepHint(u, v);}
-    ShapeRT* shape;
-};
-
 void ShapeRT::makeQuadMesh(TShapeKit* parent, const QSize& dims, bool forceIndexed)
 {
     MaterialGL* mGL = (MaterialGL*) parent->material.getValue();
@@ -149,39 +180,22 @@ void ShapeRT::makeQuadMesh(TShapeKit* parent, const QSize& dims, bool forceIndex
 
     if (ProfilePolygon* profilePolygon = dynamic_cast<ProfilePolygon*>(profile))
     {
-        // call
+        // outline until the mesh is made in makePolygonMesh
         const QPolygonF& qpolygon = profilePolygon->getPolygon();
-//        QSizeF rect = qpolygon.boundingRect().size();
-//        double s = std::min(rect.width()/(dims.width() - 1), rect.height()/(dims.height() - 1));
-
-        MeshDensityShape mds;
-        mds.shape = (ShapeRT*) parent->shapeRT.getValue();
 
-
-        PolygonMesh polygonMesh(qpolygon);
-//        if (!polygonMesh.makeMesh(s))
-//            return;
-        if (!polygonMesh.makeMesh(1e8, mds))
-            return;
-
-        // fill
         QVector<SbVec3f> vertices;
         QVector<SbVec3f> normals;
-        for (const vec2d& uv : polygonMesh.getPoints()) {
-            vec3d point = getPoint(uv.x, uv.y);
-            vec3d normal = getNormal(uv.x, uv.y);
+        QVector<int> lines;
+        for (const QPointF& uv : qpolygon) {
+            vec3d point = getPoint(uv.x(), uv.y());
+            vec3d normal = getNormal(uv.x(), uv.y());
             if (reverseNormals) normal = -normal;
+            lines << vertices.size();
             vertices << SbVec3f(point.x, point.y, point.z);
             normals << SbVec3f(normal.x, normal.y, normal.z);
         }
-
-        QVector<int> faces;
-        for (const auto& tri : polygonMesh.getTriangles()) {
-            faces << tri.a;
-            faces << tri.b;
-            faces << tri.c;
-            faces << SO_END_FACE_INDEX;
-        }
+        if (!lines.isEmpty()) lines << 0;
+        lines << SO_END_LINE_INDEX;
 
         SoCoordinate3* sVertices = new SoCoordinate3;
         sVertices->point.setValues(0, vertices.size(), vertices.data());
@@ -191,9 +205,11 @@ void ShapeRT::makeQuadMesh(TShapeKit* parent, const QSize& dims, bool forceIndex
         sNormals->vector.setValues(0, normals.size(), normals.data());
         shapeKit->setPart("normal", sNormals);
 
-        SoIndexedFaceSet* sMesh = new SoIndexedFaceSet;
-        sMesh->coordIndex.setValues(0, faces.size(), faces.data());
+        SoIndexedLineSet* sMesh = new SoIndexedLineSet;
+        sMesh->coordIndex.setValues(0, lines.size(), lines.data());
         shapeKit->setPart("shape", sMesh);
+
+        parent->m_meshPending = true;
     }
     else
     {
@@ -240,3 +256,67 @@ void ShapeRT::makeQuadMesh(TShapeKit* parent, const QSize& dims, bool forceIndex
         }
     }
 }
+
+/*!
+ * Starts the mesh of the polygon profile of \a parent in PolygonMeshCache,
+ * the outline made in makeQuadMesh is replaced when the mesh is ready.
+ * The mesh is skipped if the kit was changed meanwhile.
+ */
+void ShapeRT::makePolygonMesh(TShapeKit* parent)
+{
+    ProfilePolygon* profile = dynamic_cast<ProfilePolygon*>(parent->profileRT.getValue());
+    if (!profile) return;
+
+    QFuture<PolygonMeshCache::Mesh> future = PolygonMeshCache::find(this, profile->getPolygon());
+    int version = parent->m_meshVersion;
+    parent->ref();
+
+    QFutureWatcher<PolygonMeshCache::Mesh>* watcher = new QFutureWatcher<PolygonMeshCache::Mesh>;
+    QObject::connect(watcher, &QFutureWatcher<PolygonMeshCache::Mesh>::finished, [watcher, parent, version]() {
+        PolygonMeshCache::Mesh mesh = watcher->result();
+        if (mesh && parent->m_meshVersion == version) {
+            ShapeRT* shape = (ShapeRT*) parent->shapeRT.getValue();
+            shape->fillPolygonMesh(parent, *mesh);
+        }
+        parent->unref();
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
+void ShapeRT::fillPolygonMesh(TShapeKit* parent, const PolygonMesh& polygonMesh)
+{
+    MaterialGL* mGL = (MaterialGL*) parent->material.getValue();
+    bool reverseNormals = mGL->reverseNormals.getValue();
+    SoShapeKit* shapeKit = parent->m_shapeKit;
+
+    QVector<SbVec3f> vertices;
+    QVector<SbVec3f> normals;
+    for (const vec2d& uv : polygonMesh.getPoints()) {
+        vec3d point = getPoint(uv.x, uv.y);
+        vec3d normal = getNormal(uv.x, uv.y);
+        if (reverseNormals) normal = -normal;
+        vertices << SbVec3f(point.x, point.y, point.z);
+        normals << SbVec3f(normal.x, normal.y, normal.z);
+    }
+
+    QVector<int> faces;
+    for (const auto& tri : polygonMesh.getTriangles()) {
+        faces << tri.a;
+        faces << tri.b;
+        faces << tri.c;
+        faces << SO_END_FACE_INDEX;
+    }
+
+    SoCoordinate3* sVertices = new SoCoordinate3;
+    sVertices->point.setValues(0, vertices.size(), vertices.data());
+    shapeKit->setPart("coordinate3", sVertices);
+
+    SoNormal* sNormals = new SoNormal;
+    sNormals->vector.setValues(0, normals.size(), normals.data());
+    shapeKit->setPart("normal", sNormals);
+
+    SoIndexedFaceSet* sMesh = new SoIndexedFaceSet;
+    sMesh->coordIndex.setValues(0, faces.size(), faces.data());
+    shapeKit->setPart("shape", sMesh);
+}
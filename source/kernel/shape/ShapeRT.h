@@ -2,6 +2,8 @@
 
 #include "kernel/node/TNode.h"
 
+#include <QVector>
+
 struct vec2d;
 struct vec3d;
 struct Box3D;
@@ -10,6 +12,7 @@ struct DifferentialGeometry;
 class QSize;
 class TShapeKit;
 class ProfileRT;
+class PolygonMesh;
 class Transform;
 
 
@@ -31,8 +34,11 @@ public:
     virtual vec2d getUV(const vec3d& p) const;
     virtual double getStepHint(double u, double v) const;
     virtual void updateShapeGL(TShapeKit* /*parent*/) {}
+    void makePolygonMesh(TShapeKit* parent);
 
     virtual Box3D getBox(ProfileRT* profile) const;
+    // points with convex hull covering the surface, for the sun aperture
+    virtual QVector<vec3d> getHull(ProfileRT* profile) const;
     // with computing dg, ray in local coordinates
     virtual bool intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const;
     // without computing dg
@@ -43,6 +49,8 @@ public:
 
 protected:
     void makeQuadMesh(TShapeKit* parent, const QSize& dims, bool forceIndexed = false);
+    void fillPolygonMesh(TShapeKit* parent, const PolygonMesh& polygonMesh);
+    QVector<vec3d> makeHull(ProfileRT* profile, const QSize& dims) const;
 };
 
 
@@ -0,0 +1,134 @@
+#include "TriangleMesh.h"
+
+#include "kernel/shape/DifferentialGeometry.h"
+
+
+void TriangleMesh::clear()
+{
+    m_pC.clear();
+    m_eu.clear();
+    m_ev.clear();
+    m_nA.clear();
+    m_nB.clear();
+    m_nC.clear();
+    m_tolerance.clear();
+    m_boxes.clear();
+    m_bvh.clear();
+}
+
+void TriangleMesh::reserve(int n)
+{
+    m_pC.reserve(n);
+    m_eu.reserve(n);
+    m_ev.reserve(n);
+    m_nA.reserve(n);
+    m_nB.reserve(n);
+    m_nC.reserve(n);
+    m_tolerance.reserve(n);
+    m_boxes.reserve(n);
+}
+
+void TriangleMesh::addTriangle(
+    const vec3d& pA, const vec3d& pB, const vec3d& pC,
+    const vec3d& nA, const vec3d& nB, const vec3d& nC
+)
+{
+    vec3d eu = pA - pC;
+    vec3d ev = pB - pC;
+    m_pC.push_back(pC);
+    m_eu.push_back(eu);
+    m_ev.push_back(ev);
+    m_nA.push_back(nA);
+    m_nB.push_back(nB);
+    m_nC.push_back(nC);
+    m_tolerance.push_back(eu.norm()*ev.norm()*1e-6);
+
+    Box3D box;
+    box << pA;
+    box << pB;
+    box << pC;
+    m_boxes.push_back(box);
+}
+
+void TriangleMesh::build(int leafSize)
+{
+    m_bvh.build(m_boxes, leafSize);
+}
+
+/*!
+ * The traversal keeps only the parameters of the nearest triangle,
+ * the differential geometry is made once for the final hit.
+ */
+bool TriangleMesh::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg) const
+{
+    if (m_bvh.isEmpty()) return false;
+
+    if (tHit == 0 && dg == 0) {
+        auto f = [this](int index, const Ray& r) {
+            double t, u, v;
+            return intersectTriangle(index, r, t, u, v);
+        };
+        return m_bvh.intersectP(ray, f);
+    }
+
+    Ray rayT = ray; // tMax decreases during traversal
+    int indexHit = -1;
+    double uHit = 0.;
+    double vHit = 0.;
+    auto f = [&](int index, const Ray& r) {
+        double t, u, v;
+        if (!intersectTriangle(index, r, t, u, v)) return false;
+        r.tMax = t;
+        indexHit = index;
+        uHit = u;
+        vHit = v;
+        return true;
+    };
+    m_bvh.intersect(rayT, f);
+    if (indexHit < 0) return false;
+
+    if (tHit) *tHit = rayT.tMax;
+    if (dg) makeGeometry(indexHit, ray, rayT.tMax, uHit, vHit, dg);
+    return true;
+}
+
+bool TriangleMesh::intersectTriangle(int index, const Ray& ray, double& t, double& u, double& v) const
+{
+    // https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+    const vec3d& eu = m_eu[index];
+    const vec3d& ev = m_ev[index];
+    double tolerance = m_tolerance[index];
+
+    vec3d qv = cross(ray.direction(), ev);
+    double det = dot(eu, qv);
+    if (std::abs(det) < tolerance) return false;
+    double detInv = 1./det;
+
+    vec3d qt = ray.origin - m_pC[index];
+    u = dot(qv, qt)*detInv;
+    if (u < 0. || u > 1.) return false;
+
+    vec3d qu = cross(qt, eu);
+    v = dot(qu, ray.direction())*detInv;
+    if (v < 0. || u + v > 1.) return false;
+
+    t = dot(qu, ev)*detInv;
+    if (t < ray.tMin + tolerance || t > ray.tMax) return false;
+    return true;
+}
+
+void TriangleMesh::makeGeometry(int index, const Ray& ray, double t, double u, double v, DifferentialGeometry* dg) const
+{
+    vec3d vN = u*m_nA[index] + v*m_nB[index] + (1. - u - v)*m_nC[index];
+    vN.normalize();
+    vec3d vU = vN.findOrthogonal().normalize();
+    vec3d vV = cross(vN, vU);
+
+    dg->point = ray.point(t);
+    dg->uv = vec2d(u, v);
+    dg->dpdu = vU;
+    dg->dpdv = vV;
+    dg->normal = vN;
+    dg->shape = 0;
+    dg->isFront = dot(vN, ray.direction()) <= 0.;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <vector>
+
+#include "libraries/math/3D/BVH.h"
+
+struct DifferentialGeometry;
+
+
+//! TriangleMesh is a set of triangles with smooth normals for ray tracing.
+/*!
+ * The triangles are stored as separate arrays of vertices, edges and normals.
+ * Call build after adding the triangles to construct the BVH over them.
+ * Shared by the mesh and function shapes.
+ */
+class TONATIUH_KERNEL TriangleMesh
+{
+public:
+    TriangleMesh() {}
+
+    void clear();
+    void reserve(int n);
+    void addTriangle(
+        const vec3d& pA, const vec3d& pB, const vec3d& pC,
+        const vec3d& nA, const vec3d& nB, const vec3d& nC
+    );
+    void build(int leafSize = 4);
+
+    int size() const {return int(m_pC.size());}
+    bool isEmpty() const {return m_bvh.isEmpty();}
+    Box3D box() const {return m_bvh.box();}
+
+    // nearest hit, any hit if tHit and dg are null
+    bool intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg) const;
+
+private:
+    bool intersectTriangle(int index, const Ray& ray, double& t, double& u, double& v) const;
+    void makeGeometry(int index, const Ray& ray, double t, double u, double v, DifferentialGeometry* dg) const;
+
+    // corner C, edges A - C and B - C
+    std::vector<vec3d> m_pC;
+    std::vector<vec3d> m_eu;
+    std::vector<vec3d> m_ev;
+    std::vector<vec3d> m_nA;
+    std::vector<vec3d> m_nB;
+    std::vector<vec3d> m_nC;
+    std::vector<double> m_tolerance;
+    std::vector<Box3D> m_boxes;
+
+    BVH m_bvh;
+};
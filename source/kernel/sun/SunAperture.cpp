@@ -15,6 +15,8 @@
 #include <Inventor/elements/SoMaterialBindingElement.h>
 
 #include <math.h>
+#include <algorithm>
+#include <bitset>
 #include "libraries/math/3D/Box3D.h"
 #include "libraries/math/3D/Ray.h"
 #include "libraries/math/3D/Transform.h"
@@ -36,7 +38,8 @@ void SunAperture::initClass()
 
 SunAperture::SunAperture():
     m_xCells(0),
-    m_yCells(0)
+    m_yCells(0),
+    m_subcells(0)
 {
     SO_NODE_CONSTRUCTOR(SunAperture);
     isBuiltIn = TRUE;
@@ -55,26 +58,46 @@ SunAperture::~SunAperture()
 
 }
 
+/*!
+ * Returns the area of the covered subcells.
+ */
 double SunAperture::getArea() const
 {
-    double dx = (m_xMax - m_xMin)/m_xCells;
-    double dy = (m_yMax - m_yMin)/m_yCells;
-    return dx*dy*m_cells.size();
+    if (m_cells.empty()) return 0.;
+    double dx = (m_xMax - m_xMin)/(m_xCells*SubDivisions);
+    double dy = (m_yMax - m_yMin)/(m_yCells*SubDivisions);
+    return dx*dy*m_subcells;
 }
 
 /*!
- * Returns the indexes of the valid areas to the ray tracer.
+ * Returns a point on the covered area for uniform numbers \a s, \a u, \a v.
+ * The cell is taken by \a s with probability proportional to its coverage,
+ * so all points have the same density and the same weight getArea()/rays.
  */
-vec3d SunAperture::Sample(double u, double v, int w, int h) const //? w <> h
+vec3d SunAperture::Sample(double s, double u, double v) const
 {
-    if (u < 0. || u > 1. || v < 0. || v > 1.)
-        gcf::SevereError("Function SunAperture::GetPoint3D called with invalid parameters");
+    int n = m_table.sample(s);
+    const QPair<int, int>& cell = m_cells[n];
+    quint16 mask = m_masks[n];
+
+    // covered subcell by u, the fraction of u is reused inside of the subcell
+    int count = int(std::bitset<16>(mask).count());
+    double uc = u*count;
+    int k = std::min(int(uc), count - 1);
+    u = uc - k;
+
+    int b = 0;
+    for (; b < 16; ++b) {
+        if (!(mask & (1 << b))) continue;
+        if (k == 0) break;
+        k--;
+    }
 
-    double xWidth = (m_xMax - m_xMin)/m_xCells;
-    double yWidth = (m_yMax - m_yMin)/m_yCells;
+    double xStep = (m_xMax - m_xMin)/(m_xCells*SubDivisions);
+    double yStep = (m_yMax - m_yMin)/(m_yCells*SubDivisions);
 
-    double x = m_xMin + (w + u)*xWidth;
-    double y = m_yMin + (h + v)*yWidth;
+    double x = m_xMin + (cell.first*SubDivisions + b%SubDivisions + u)*xStep;
+    double y = m_yMin + (cell.second*SubDivisions + b/SubDivisions + v)*yStep;
 
     return vec3d(x, y, 0.);
 }
@@ -91,21 +114,55 @@ void SunAperture::setSize(double xMin, double xMax, double yMin, double yMax, do
     disabledNodes = disabledNodes.getValue().getString(); // for update
 }
 
+// monotone chain
+static QPolygonF makeConvexHull(QVector<QPointF> ps)
+{
+    if (ps.size() < 3) return QPolygonF(ps);
+
+    std::sort(ps.begin(), ps.end(), [](const QPointF& a, const QPointF& b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+
+    auto cross = [](const QPointF& o, const QPointF& a, const QPointF& b) {
+        return (a.x() - o.x())*(b.y() - o.y()) - (a.y() - o.y())*(b.x() - o.x());
+    };
+
+    QVector<QPointF> hull(2*ps.size());
+    int k = 0;
+    for (int n = 0; n < ps.size(); ++n) { // lower
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], ps[n]) <= 0.) k--;
+        hull[k++] = ps[n];
+    }
+    for (int n = ps.size() - 2, t = k + 1; n >= 0; --n) { // upper
+        while (k >= t && cross(hull[k - 2], hull[k - 1], ps[n]) <= 0.) k--;
+        hull[k++] = ps[n];
+    }
+    hull.resize(k - 1);
+    return QPolygonF(hull);
+}
+
+/*!
+ * Finds the cells of the aperture crossed by the rays to \a surfaces.
+ * The hulls of the surfaces are projected on a raster with SubDivisions per cell,
+ * dilated by delta and one subcell, and the covered subcells are kept for each cell.
+ */
 void SunAperture::findTexture(int xPixels, int yPixels, QVector<QPair<TShapeKit*, Transform> > surfaces, SunKit* sunKit)
 {
     double xWidth = m_xMax - m_xMin;
     double yWidth = m_yMax - m_yMin;
 
-    while (xWidth / xPixels < m_delta) xPixels--;
-    double xStep = xWidth/xPixels;
+    while (xPixels > 1 && xWidth / xPixels < m_delta) xPixels--;
+    while (yPixels > 1 && yWidth / yPixels < m_delta) yPixels--;
 
-    while (yWidth / yPixels < m_delta) yPixels--;
-    double yStep = yWidth/yPixels;
+    int xSubs = xPixels*SubDivisions;
+    int ySubs = yPixels*SubDivisions;
+    double xStep = xWidth/xSubs;
+    double yStep = yWidth/ySubs;
 
-    QImage* image = new QImage(xPixels, yPixels, QImage::Format_Grayscale8);
-    image->fill(Qt::black);
+    QImage image(xSubs, ySubs, QImage::Format_Grayscale8);
+    image.fill(Qt::black);
 
-    QPainter painter(image);
+    QPainter painter(&image);
 
     QBrush brush(Qt::white);
     painter.setBrush(brush);
@@ -121,57 +178,46 @@ void SunAperture::findTexture(int xPixels, int yPixels, QVector<QPair<TShapeKit*
         if (!shape) continue;
         ProfileRT* aperture = static_cast<ProfileRT*>(s.first->profileRT.getValue());
         if (!aperture) continue;
-        Box3D box = shape->getBox(aperture);
-
-        const vec3d& vA = box.min();
-        const vec3d& vB = box.max();
-        QVector<vec3d> ps;
-        ps << vec3d(vA.x, vA.y, vA.z);
-        ps << vec3d(vA.x, vA.y, vB.z);
-        ps << vec3d(vA.x, vB.y, vA.z);
-        ps << vec3d(vA.x, vB.y, vB.z);
-        ps << vec3d(vB.x, vA.y, vA.z);
-        ps << vec3d(vB.x, vA.y, vB.z);
-        ps << vec3d(vB.x, vB.y, vA.z);
-        ps << vec3d(vB.x, vB.y, vB.z);
 
         QVector<QPointF> qps;
-        for (vec3d& p : ps) {
-            p = s.second.transformPoint(p);
-            QPointF q((p.x - m_xMin)/xStep, (p.y - m_yMin)/yStep);
+        for (const vec3d& p : shape->getHull(aperture)) {
+            vec3d pt = s.second.transformPoint(p);
+            QPointF q((pt.x - m_xMin)/xStep, (pt.y - m_yMin)/yStep);
             qps << q;
             painter.drawPoint(q); // for polygons smaller than pixel
         }
-
-        painter.drawPolygon(QPolygonF({qps[0], qps[1], qps[3], qps[2]})); // -x
-        painter.drawPolygon(QPolygonF({qps[4], qps[5], qps[7], qps[6]})); // +x
-        painter.drawPolygon(QPolygonF({qps[0], qps[4], qps[5], qps[1]})); // -y
-        painter.drawPolygon(QPolygonF({qps[2], qps[6], qps[7], qps[3]})); // +y
-        painter.drawPolygon(QPolygonF({qps[0], qps[4], qps[6], qps[2]})); // -z
-        painter.drawPolygon(QPolygonF({qps[5], qps[1], qps[3], qps[7]})); // +z
+        painter.drawPolygon(makeConvexHull(qps));
     }
+    painter.end();
 
-    int** areaMatrix = new int*[yPixels];
-    for (int i = 0; i < yPixels; i++)
-        areaMatrix[i] = new int[xPixels];
+    // dilation by delta for the spread of sun rays
+    int xRadius = 1 + int(ceil(m_delta/xStep));
+    int yRadius = 1 + int(ceil(m_delta/yStep));
 
-    QVector<uchar> bmp;
-    bmp.resize(xPixels*yPixels);
+    std::vector<uchar> bmpX(xSubs*ySubs, 0); // dilated along x
+    for (int j = 0; j < ySubs; ++j)
+    {
+        const uchar* line = image.constScanLine(j);
+        for (int i = 0; i < xSubs; ++i)
+        {
+            if (!line[i]) continue;
+            int iMin = std::max(i - xRadius, 0);
+            int iMax = std::min(i + xRadius, xSubs - 1);
+            for (int qi = iMin; qi <= iMax; ++qi)
+                bmpX[j*xSubs + qi] = 1;
+        }
+    }
 
-    QRgb black = qRgb(0, 0, 0);
-    for (int i = 0; i < xPixels; ++i)
+    std::vector<uchar> bmp(xSubs*ySubs, 0);
+    for (int j = 0; j < ySubs; ++j)
     {
-        for (int j = 0; j < yPixels; ++j)
+        int jMin = std::max(j - yRadius, 0);
+        int jMax = std::min(j + yRadius, ySubs - 1);
+        for (int i = 0; i < xSubs; ++i)
         {
-            int v = 0;
-            for (int qi = i - 1; qi <= i + 1; ++qi)
-                for (int qj = j - 1; qj <= j + 1; ++qj)
-                {
-                    if (qi < 0 || qi >= xPixels) continue;
-                    if (qj < 0 || qj >= yPixels) continue;
-                    v += image->pixel(qi, qj) == black ? 0 : 1;
-                }
-            bmp[i*yPixels + j] = v > 0 ? 255 : 0;
+            if (!bmpX[j*xSubs + i]) continue;
+            for (int qj = jMin; qj <= jMax; ++qj)
+                bmp[qj*xSubs + i] = 1;
         }
     }
 
@@ -179,21 +225,41 @@ void SunAperture::findTexture(int xPixels, int yPixels, QVector<QPair<TShapeKit*
     m_yCells = yPixels;
 
     m_cells.clear();
+    m_masks.clear();
+    m_subcells = 0;
+    std::vector<double> weights;
 
     for (int i = 0; i < m_xCells; ++i)
+    {
         for (int j = 0; j < m_yCells; ++j)
-            if (bmp[i*m_yCells + j] > 0)
-                m_cells.push_back(QPair<int, int>(i, j));
+        {
+            quint16 mask = 0;
+            for (int b = 0; b < SubDivisions*SubDivisions; ++b) {
+                int qi = i*SubDivisions + b%SubDivisions;
+                int qj = j*SubDivisions + b/SubDivisions;
+                if (bmp[qj*xSubs + qi]) mask |= 1 << b;
+            }
+            if (!mask) continue;
+
+            int count = int(std::bitset<16>(mask).count());
+            m_cells.push_back(QPair<int, int>(i, j));
+            m_masks.push_back(mask);
+            weights.push_back(count);
+            m_subcells += count;
+        }
+    }
+
+    m_table.build(weights);
 
     Q_UNUSED(sunKit)
 //    QVector<uchar> bmpTr;
-//    bmpTr.resize(xPixels*yPixels);
-//    for (int i = 0; i < xPixels; ++i)
-//        for (int j = 0; j < yPixels; ++j)
-//            bmpTr[j*xPixels + i] = bmp[i*yPixels + j];
+//    bmpTr.resize(xSubs*ySubs);
+//    for (int i = 0; i < xSubs; ++i)
+//        for (int j = 0; j < ySubs; ++j)
+//            bmpTr[j*xSubs + i] = 255*bmp[j*xSubs + i];
 
 //    SoTexture2* texture = static_cast<SoTexture2*>(sunKit->getPart("iconTexture", true));
-//    texture->image.setValue(SbVec2s(xPixels, yPixels), 1, bmpTr.data()); // 1 is for gray
+//    texture->image.setValue(SbVec2s(xSubs, ySubs), 1, bmpTr.data()); // 1 is for gray
 //    texture->wrapS = SoTexture2::CLAMP;
 //    texture->wrapT = SoTexture2::CLAMP;
 }
@@ -12,6 +12,7 @@
 
 #include "kernel/shape/ShapeRT.h"
 #include "kernel/node/TonatiuhTypes.h"
+#include "libraries/math/1D/AliasTable.h"
 #include "libraries/math/3D/vec3d.h"
 
 class Transform;
@@ -29,7 +30,7 @@ public:
     double getArea() const;
     const std::vector< QPair<int, int> >& getCells() const {return m_cells;}
 
-    vec3d Sample(double u, double v, int w, int h) const;
+    vec3d Sample(double s, double u, double v) const;
 
     void setSize(double xMin, double xMax, double yMin, double yMax, double delta);
     void findTexture(int widthDivisions, int heightDivisions, QVector< QPair<TShapeKit*, Transform> > surfaces, SunKit* sunKit);
@@ -50,5 +51,10 @@ private:
 
     int m_xCells;
     int m_yCells;
-    std::vector< QPair<int, int> > m_cells;
+    std::vector< QPair<int, int> > m_cells; // cells with coverage
+    std::vector<quint16> m_masks; // covered subcells of cells
+    int m_subcells; // covered subcells of all cells
+    AliasTable m_table; // cells by coverage
+
+    static const int SubDivisions = 4; // subcells per side of cell
 };
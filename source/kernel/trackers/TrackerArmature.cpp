@@ -1,5 +1,9 @@
 #include "TrackerArmature.h"
 
+#include "kernel/node/TonatiuhFunctions.h"
+#include "libraries/math/2D/vec2d.h"
+#include "TrackerTarget.h"
+
 
 SO_NODE_ABSTRACT_SOURCE(TrackerArmature)
 
@@ -12,9 +16,18 @@ void TrackerArmature::initClass()
 void TrackerArmature::update(TSeparatorKit* parent, const Transform& toGlobal, const vec3d& vSun, TrackerTarget* target)
 {
     Q_UNUSED(parent)
+    vec3d rAim = tgf::makeVector3D(target->aimingPoint.getValue());
+    vec2d angles = solve(toGlobal, vSun, target->aimingType.getValue(), rAim);
+    target->angles.setValue(angles.x, angles.y);
+}
+
+vec2d TrackerArmature::solve(const Transform& toGlobal, const vec3d& vSun, int aimingType, const vec3d& aimingPoint) const
+{
     Q_UNUSED(toGlobal)
     Q_UNUSED(vSun)
-    Q_UNUSED(target)
+    Q_UNUSED(aimingType)
+    Q_UNUSED(aimingPoint)
+    return vec2d(0., 0.);
 }
 
 void TrackerArmature::updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target)
@@ -7,6 +7,7 @@
 class TSeparatorKit;
 class Transform;
 class SoShapeKit;
+struct vec2d;
 struct vec3d;
 class TrackerTarget;
 
@@ -21,6 +22,11 @@ public:
     virtual void update(TSeparatorKit* parent, const Transform& toGlobal,
                         const vec3d& vSun, TrackerTarget* target);
 
+    // angles in degrees, aimingType and aimingPoint as in TrackerTarget
+    // reads only plain members, safe to call from several threads
+    virtual vec2d solve(const Transform& toGlobal, const vec3d& vSun,
+                        int aimingType, const vec3d& aimingPoint) const;
+
     virtual void updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target);
 
     NAME_ICON_FUNCTIONS("X", ":/TrackerX.png")
@@ -45,24 +45,24 @@ TrackerArmature1A::~TrackerArmature1A()
     delete m_solver;
 }
 
-void TrackerArmature1A::update(TSeparatorKit* /*parent*/, const Transform& toGlobal,
-                               const vec3d& vSun, TrackerTarget* target)
+vec2d TrackerArmature1A::solve(const Transform& toGlobal, const vec3d& vSun,
+                               int aimingType, const vec3d& aimingPoint) const
 {
     Transform toLocal = toGlobal.inversed();
     vec3d vSunL = toLocal.transformVector(vSun);
-    vec3d rAim = tgf::makeVector3D(target->aimingPoint.getValue());
+    vec3d rAim = aimingPoint;
 
     double angle;
-    if (target->aimingType.getValue() == TrackerTarget::global) {
+    if (aimingType == TrackerTarget::global) {
         rAim = toLocal.transformPoint(rAim);
         angle = m_solver->solveReflectionGlobal(vSunL, rAim);
-    } else if (target->aimingType.getValue() == TrackerTarget::local) {
+    } else if (aimingType == TrackerTarget::local) {
         angle = m_solver->solveReflectionPrimary(vSunL, rAim);
     } else {
         angle = 0;
     }
     angle = m_solver->selectSolution(angle);
-    target->angles.setValue(angle/gcf::degree, 0.);
+    return vec2d(angle/gcf::degree, 0.);
 }
 
 void TrackerArmature1A::updateShape(TSeparatorKit* parent, SoShapeKit* /*shape*/, TrackerTarget* target)
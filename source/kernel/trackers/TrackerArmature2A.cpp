@@ -72,21 +72,21 @@ static SoTransform* findPart(SoShapeKit* parent, const char* name)
 }
 
 #include <QDebug>
-void TrackerArmature2A::update(TSeparatorKit* /*parent*/, const Transform& toGlobal,
-                               const vec3d& vSun, TrackerTarget* target)
+vec2d TrackerArmature2A::solve(const Transform& toGlobal, const vec3d& vSun,
+                               int aimingType, const vec3d& aimingPoint) const
 {
     QVector<Angles> solutions;
     Transform toLocal = toGlobal.inversed();
     vec3d vSunL = toLocal.transformVector(vSun);
-    vec3d rAim = tgf::makeVector3D(target->aimingPoint.getValue());
-    if (target->aimingType.getValue() == TrackerTarget::global) {
+    vec3d rAim = aimingPoint;
+    if (aimingType == TrackerTarget::global) {
         rAim = toLocal.transformPoint(rAim);
         solutions = m_solver->solveReflectionGlobal(vSunL, rAim);
-    } else if (target->aimingType.getValue() == TrackerTarget::local) {
+    } else if (aimingType == TrackerTarget::local) {
         solutions = m_solver->solveReflectionSecondary(vSunL, rAim);
     }
     Angles solution = m_solver->selectSolution(solutions);
-    target->angles.setValue(solution.x/gcf::degree, solution.y/gcf::degree);
+    return solution/gcf::degree;
 }
 
 void TrackerArmature2A::updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target)
@@ -17,8 +17,8 @@ public:
     static void initClass();
     TrackerArmature2A();
 
-    void update(TSeparatorKit* parent, const Transform& toGlobal,
-                const vec3d& vSun, TrackerTarget* target);
+    vec2d solve(const Transform& toGlobal, const vec3d& vSun,
+                int aimingType, const vec3d& aimingPoint) const;
 
     void updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target);
 
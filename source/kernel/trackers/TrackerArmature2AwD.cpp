@@ -58,22 +58,6 @@ static double findAngle(const SbVec3f& a, SbVec3f m, SbVec3f v)
     return atan2(a.dot(m.cross(v)), m.dot(v));
 }
 
-void TrackerArmature2AwD::update(TSeparatorKit* /*parent*/, const Transform& toGlobal, const vec3d& vSun, TrackerTarget* target)
-{
-    QVector<Angles> solutions;
-    Transform toLocal = toGlobal.inversed();
-    vec3d vSunL = toLocal.transformVector(vSun);
-    vec3d rAim = tgf::makeVector3D(target->aimingPoint.getValue());
-    if (target->aimingType.getValue() == TrackerTarget::global) {
-        rAim = toLocal.transformPoint(rAim);
-        solutions = m_solver->solveReflectionGlobal(vSunL, rAim);
-    } else if (target->aimingType.getValue() == TrackerTarget::local) {
-        solutions = m_solver->solveReflectionSecondary(vSunL, rAim);
-    }
-    Angles solution = m_solver->selectSolution(solutions);
-    target->angles.setValue(solution.x/gcf::degree, solution.y/gcf::degree);
-}
-
 void TrackerArmature2AwD::updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target)
 {
     float alpha = target->angles.getValue()[0]*gcf::degree;
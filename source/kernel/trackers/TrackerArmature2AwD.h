@@ -11,9 +11,6 @@ public:
     static void initClass();
     TrackerArmature2AwD();
 
-    void update(TSeparatorKit* parent, const Transform& toGlobal,
-                const vec3d& vSun, TrackerTarget* target);
-
     void updateShape(TSeparatorKit* parent, SoShapeKit* shape, TrackerTarget* target);
 
     SoSFVec3f drivePrimaryR;
@@ -0,0 +1,119 @@
+#include "TrackerBatch.h"
+
+#include <QtConcurrent>
+
+#include <Inventor/nodes/SoGroup.h>
+
+#include "kernel/node/TonatiuhFunctions.h"
+#include "kernel/scene/TArrayKit.h"
+#include "kernel/scene/TSceneKit.h"
+#include "kernel/scene/TSeparatorKit.h"
+#include "kernel/scene/TTransform.h"
+#include "kernel/sun/SunPosition.h"
+#include "TrackerArmature.h"
+#include "TrackerKit.h"
+#include "TrackerTarget.h"
+
+
+TrackerBatch::TrackerBatch(TSceneKit* scene):
+    m_scene(scene),
+    m_ignored(0)
+{
+    collect();
+}
+
+void TrackerBatch::collect()
+{
+    m_items.clear();
+    m_ignored = 0;
+    TSeparatorKit* layout = m_scene->getLayout();
+    if (layout) collect(layout, Transform::Identity);
+    if (m_ignored > 0)
+        qWarning("TrackerBatch: %d trackers inside arrays are not updated", m_ignored);
+}
+
+void TrackerBatch::collect(TSeparatorKit* parent, const Transform& toGlobal)
+{
+    TTransform* tParent = (TTransform*) parent->getPart("transform", true);
+    Transform t = toGlobal*tgf::makeTransform(tParent);
+
+    SoGroup* nodes = (SoGroup*) parent->getPart("group", false);
+    if (!nodes) return;
+
+    for (int n = 0; n < nodes->getNumChildren(); ++n)
+    {
+        SoNode* node = nodes->getChild(n);
+        if (node->getTypeId().isDerivedFrom(TSeparatorKit::getClassTypeId()))
+            collect((TSeparatorKit*) node, t);
+        else if (node->getTypeId().isDerivedFrom(TrackerKit::getClassTypeId())) {
+            TrackerKit* kit = (TrackerKit*) node;
+            if (!kit->enabled.getValue()) continue;
+            kit->m_parent = parent;
+
+            Item item;
+            item.kit = kit;
+            item.armature = (TrackerArmature*) kit->armature.getValue();
+            item.target = (TrackerTarget*) kit->target.getValue();
+            if (!item.armature || !item.target) continue;
+            item.toGlobal = t;
+            item.aimingType = item.target->aimingType.getValue();
+            item.aimingPoint = tgf::makeVector3D(item.target->aimingPoint.getValue());
+            item.angles = tgf::makeVector2D(item.target->angles.getValue());
+            m_items.push_back(item);
+        }
+        else if (node->getTypeId().isDerivedFrom(TArrayKit::getClassTypeId()))
+            m_ignored += countTrackers(((TArrayKit*) node)->child.getValue());
+    }
+}
+
+// the copies of an array share one child, its trackers have no orientation per copy
+int TrackerBatch::countTrackers(SoNode* node)
+{
+    if (!node) return 0;
+    if (node->getTypeId().isDerivedFrom(TrackerKit::getClassTypeId()))
+        return ((TrackerKit*) node)->enabled.getValue() ? 1 : 0;
+    if (node->getTypeId().isDerivedFrom(TArrayKit::getClassTypeId()))
+        return countTrackers(((TArrayKit*) node)->child.getValue());
+    if (!node->getTypeId().isDerivedFrom(TSeparatorKit::getClassTypeId())) return 0;
+
+    SoGroup* nodes = (SoGroup*) ((TSeparatorKit*) node)->getPart("group", false);
+    if (!nodes) return 0;
+    int ans = 0;
+    for (int n = 0; n < nodes->getNumChildren(); ++n)
+        ans += countTrackers(nodes->getChild(n));
+    return ans;
+}
+
+void TrackerBatch::solve(const vec3d& vSun)
+{
+    QtConcurrent::blockingMap(m_items, [&vSun](Item& item) {
+        item.angles = item.armature->solve(item.toGlobal, vSun, item.aimingType, item.aimingPoint);
+    });
+}
+
+/*!
+ * Writes the solved angles to the targets and rotates the tracker nodes.
+ * The scene notifies its observers once at the end.
+ */
+void TrackerBatch::commit()
+{
+    SbBool notify = m_scene->enableNotify(FALSE);
+    for (Item& item : m_items)
+    {
+        SoSFVec2f& angles = item.target->angles;
+        angles.enableNotify(FALSE); // shape is updated below
+        angles.setValue(item.angles.x, item.angles.y);
+        angles.enableNotify(TRUE);
+        item.armature->updateShape(item.kit->m_parent, item.kit->m_shapeKit, item.target);
+    }
+    m_scene->enableNotify(notify);
+    if (notify) m_scene->touch();
+}
+
+void TrackerBatch::update()
+{
+    SunPosition* sp = (SunPosition*) m_scene->getPart("world.sun.position", false);
+    if (!sp || !sp->trackable.getValue()) return;
+    solve(sp->getSunVector());
+    commit();
+}
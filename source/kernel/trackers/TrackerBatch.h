@@ -0,0 +1,58 @@
+#pragma once
+
+#include "kernel/TonatiuhKernel.h"
+
+#include <vector>
+
+#include "libraries/math/2D/vec2d.h"
+#include "libraries/math/3D/Transform.h"
+
+class SoNode;
+class TSceneKit;
+class TSeparatorKit;
+class TrackerArmature;
+class TrackerKit;
+class TrackerTarget;
+
+
+//! TrackerBatch updates all trackers of a scene at once.
+/*!
+ * The trackers are collected once with their global transforms and plain copies of their targets.
+ * solve computes the angles for a sun vector in parallel without touching the scene,
+ * commit writes them to the scene with a single notification at the end.
+ * Collect again after the layout or the targets change.
+ * Trackers inside the child of a TArrayKit are shared by all copies,
+ * they are skipped and counted in ignored().
+ */
+class TONATIUH_KERNEL TrackerBatch
+{
+public:
+    TrackerBatch(TSceneKit* scene);
+
+    void collect();
+    int size() const {return int(m_items.size());}
+    int ignored() const {return m_ignored;}
+
+    void solve(const vec3d& vSun);
+    void commit();
+    void update(); // for the sun of the scene
+
+private:
+    struct Item
+    {
+        TrackerKit* kit;
+        TrackerArmature* armature;
+        TrackerTarget* target;
+        Transform toGlobal;
+        int aimingType;
+        vec3d aimingPoint;
+        vec2d angles; // in degrees
+    };
+
+    void collect(TSeparatorKit* parent, const Transform& toGlobal);
+    static int countTrackers(SoNode* node);
+
+    TSceneKit* m_scene;
+    std::vector<Item> m_items;
+    int m_ignored; // trackers in arrays
+};
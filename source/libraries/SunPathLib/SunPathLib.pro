@@ -3,6 +3,7 @@ TEMPLATE = lib
 DEFINES += SUNPATHLIB_EXPORT
 
 QT -= gui
+QT += concurrent
 CONFIG += eigen
 include(../config.pri)
 
@@ -22,6 +23,7 @@ HEADERS += \
     data/SkyModel.h \
     data/SkyModelPI.h \
     data/SunFunctor.h \
+    data/TableCSV.h \
     math/geometry/Interval.h \
     math/geometry/vec2d.h \
     math/geometry/vec3d.h \
@@ -51,6 +53,7 @@ SOURCES += \
     data/SkyModel.cpp \
     data/SkyModelPI.cpp \
     data/SunFunctor.cpp \
+    data/TableCSV.cpp \
     math/geometry/Interval.cpp \
     math/geometry/vec2d.cpp \
     math/geometry/vec3d.cpp \
@@ -1,5 +1,9 @@
 #include "FormatTMY.h"
 
+#include "TableCSV.h"
+
+#include <cmath>
+
 #include <QFile>
 #include <QTextStream>
 #include <QStringList>
@@ -20,13 +24,10 @@ FormatTMY::FormatTMY(SunTemporal* sunTemporal):
 bool FormatTMY::read(QString fileName, const ParamsTMY& params)
 {
     try {
-        QFile file(fileName);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            throw QString("File not opened: ") + fileName;
-
-        QTextStream fin(&file);
-        readInfo(fin, params);
-        readData(fin, params);
+        TableCSV table;
+        table.read(fileName, 3);
+        readInfo(table, params);
+        readData(table, params);
 
         m_message.clear();
         return true;
@@ -93,13 +94,10 @@ bool FormatTMY::write(QString fileName, const ParamsTMY& params)
     }
 }
 
-void FormatTMY::readInfo(QTextStream& fin, const ParamsTMY& /*params*/)
+void FormatTMY::readInfo(const TableCSV& table, const ParamsTMY& /*params*/)
 {
     // line 1
-    QString line = fin.readLine();
-    if (line.isNull())
-        throw QString("line 1 is missing");
-    QStringList list = line.split(',');
+    const QStringList& list = table.header(0);
 
     int iLatitude = -1;
     int iLongitude = -1;
@@ -114,38 +112,34 @@ void FormatTMY::readInfo(QTextStream& fin, const ParamsTMY& /*params*/)
     }
 
     // line 2
-    line = fin.readLine();
-    if (line.isNull())
-        throw QString("line 2 is missing");
-    list = line.split(',');
+    const QStringList& values = table.header(1);
+    QString line = values.join(',');
     bool ok;
 
     double latitude = 0.;
     if (iLatitude > 0) {
-        latitude = list[iLatitude].toDouble(&ok);
+        latitude = values.value(iLatitude).toDouble(&ok);
         if (!ok) throw QString("toDouble ") + line;
     }
     double longitude = 0.;
     if (iLongitude > 0) {
-        longitude = list[iLongitude].toDouble(&ok);
+        longitude = values.value(iLongitude).toDouble(&ok);
         if (!ok) throw QString("toDouble ") + line;
     }
 
     int offsetFromUTC = 0;
     if (iTimeZone > 0) {
-        offsetFromUTC = list[iTimeZone].toDouble(&ok)*3600;
+        offsetFromUTC = values.value(iTimeZone).toDouble(&ok)*3600;
         if (!ok) throw QString("toDouble ") + line;
     }
     Location location("TMY", latitude*sp::degree, longitude*sp::degree, offsetFromUTC);
     m_sunTemporal->calculator()->setLocation(location);
 }
 
-void FormatTMY::readData(QTextStream& fin, const ParamsTMY& params)
+void FormatTMY::readData(const TableCSV& table, const ParamsTMY& params)
 {
     // line 3
-    QString line = fin.readLine();
-    if (line.isNull()) throw QString("line 1 is missing");
-    QStringList list = line.split(',');
+    const QStringList& list = table.header(2);
 
     int iYear = -1;
     int iMonth = -1;
@@ -171,53 +165,47 @@ void FormatTMY::readData(QTextStream& fin, const ParamsTMY& params)
         else if (list[i].contains("DNI", Qt::CaseInsensitive))
             iDNI = i;
     }
+    if (iYear < 0 || iMonth < 0 || iDay < 0 || iHour < 0 || iDNI < 0)
+        throw QString("line 3 has no Year, Month, Day, Hour or DNI");
+
+    // columns are parsed as doubles, NaN for invalid numbers
+    auto column = [&](int i) -> const double* {
+        return i >= 0 ? table.column(i).constData() : 0;
+    };
+    const double* years = column(iYear);
+    const double* months = column(iMonth);
+    const double* days = column(iDay);
+    const double* hours = column(iHour);
+    const double* minutes = column(iMinute);
+    const double* seconds = column(iSecond);
+    const double* dnis = column(iDNI);
+
+    int rows = table.rows();
+    if (rows < 2) throw QString("less than 2 records");
 
-    int year = 0;
-    int month = 0;
-    int day = 0;
-    int hour = 0;
-    int minute = 0;
-    int second = 0;
-    double DNI = 0.;
-
-    bool ok;
     int offsetUTC = m_sunTemporal->calculator()->location().offsetUTC();
-    QVector<QDateTime> ts;
-    ts << QDateTime();
-    QVector<double> ds;
-
-    while (true) {
-        QString line = fin.readLine();
-        if (line.isNull()) break;
-        QStringList list = line.split(',');
-
-        year = list[iYear].toInt(&ok);
-        if (!ok) throw QString("toInt ") + line;
-
-        month = list[iMonth].toInt(&ok);
-        if (!ok) throw QString("toInt ") + line;
-
-        day = list[iDay].toInt(&ok);
-        if (!ok) throw QString("toInt ") + line;
-
-        hour = list[iHour].toInt(&ok);
-        if (!ok) throw QString("toInt ") + line;
-
-        if (iMinute > 0) {
-            minute = list[iMinute].toInt(&ok);
-            if (!ok) throw QString("toInt ") + line;
-        }
-
-        if (iSecond > 0) {
-            second = list[iSecond].toInt(&ok);
-            if (!ok) throw QString("toInt ") + line;
-        }
-
-        DNI = list[iDNI].toDouble(&ok);
-        if (!ok) throw QString("toDouble ") + line;
-
-        ts << QDateTime(QDate(year, month, day), QTime(hour, minute, second), Qt::OffsetFromUTC, offsetUTC);
-        ds << DNI;
+    QVector<QDateTime> ts(rows + 1);
+    QVector<double> ds(rows);
+
+    for (int n = 0; n < rows; ++n) {
+        double year = years[n];
+        double month = months[n];
+        double day = days[n];
+        double hour = hours[n];
+        double minute = minutes ? minutes[n] : 0.;
+        double second = seconds ? seconds[n] : 0.;
+        if (std::isnan(year + month + day + hour + minute + second))
+            throw QString("toInt in row %1").arg(n + 1);
+
+        ds[n] = dnis[n];
+        if (std::isnan(ds[n]))
+            throw QString("toDouble in row %1").arg(n + 1);
+
+        ts[n + 1] = QDateTime(
+            QDate(int(year), int(month), int(day)),
+            QTime(int(hour), int(minute), int(second)),
+            Qt::OffsetFromUTC, offsetUTC
+        );
     }
 
     int tStep = ts[1].msecsTo(ts[2]);
@@ -4,6 +4,8 @@
 
 namespace sp {
 
+class TableCSV;
+
 
 struct SUNPATHLIB ParamsTMY
 {
@@ -24,8 +26,8 @@ public:
     QString message() const {return m_message;}
 
 protected:
-    void readInfo(QTextStream& fin, const ParamsTMY& params);
-    void readData(QTextStream& fin, const ParamsTMY& params);
+    void readInfo(const TableCSV& table, const ParamsTMY& params);
+    void readData(const TableCSV& table, const ParamsTMY& params);
 
 protected:
     SunTemporal* m_sunTemporal;
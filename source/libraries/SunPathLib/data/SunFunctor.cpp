@@ -3,6 +3,12 @@
 namespace sp {
 
 
+void SunFunctor::evaluate(const double* x, const double* y, const double* z, int n, double* ans) const
+{
+    for (int i = 0; i < n; ++i)
+        ans[i] = (*this)(vec3d(x[i], y[i], z[i]));
+}
+
 double SunFunctorPanelCos::operator()(const vec3d& s) const
 {
     double ns = dot(n, s);
@@ -9,6 +9,9 @@ namespace sp {
 struct SUNPATHLIB SunFunctor
 {
     virtual double operator()(const vec3d& s) const = 0;
+
+    // values for n vectors given by arrays of components
+    virtual void evaluate(const double* x, const double* y, const double* z, int n, double* ans) const;
 };
 
 
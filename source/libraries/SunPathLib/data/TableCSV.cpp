@@ -0,0 +1,205 @@
+#include "TableCSV.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+namespace sp {
+
+
+// NaN if not a number
+static double toDouble(const char* p, const char* e)
+{
+    while (p < e && (*p == ' ' || *p == '\t')) p++;
+    while (e > p && (e[-1] == ' ' || e[-1] == '\t')) e--;
+    if (p < e && *p == '+') p++;
+
+    double ans = 0.;
+    std::from_chars_result r = std::from_chars(p, e, ans);
+    if (p == e || r.ec != std::errc() || r.ptr != e)
+        return std::numeric_limits<double>::quiet_NaN();
+    return ans;
+}
+
+TableCSV::TableCSV():
+    m_data(0),
+    m_size(0)
+{
+
+}
+
+TableCSV::~TableCSV()
+{
+    clear();
+}
+
+/*!
+ * Reads \a fileName, the first \a headerLines lines are split into m_header,
+ * the last of them gives the number of columns.
+ * Empty lines after the header are skipped.
+ */
+void TableCSV::read(QString fileName, int headerLines)
+{
+    clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        throw QString("File not opened: ") + fileName;
+
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_data = (const char*) m_file.map(0, m_size);
+        if (!m_data) throw QString("File not mapped: ") + fileName;
+    }
+
+    // header
+    qint64 pos = 0;
+    if (m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0)
+        pos = 3; // BOM
+
+    qint64 lineEnd, next;
+    for (int n = 0; n < headerLines; ++n) {
+        if (!lineAt(pos, m_size, lineEnd, next))
+            throw QString("line %1 is missing").arg(n + 1);
+        m_header << QString::fromUtf8(m_data + pos, lineEnd - pos).split(',');
+        pos = next;
+    }
+
+    // chunks aligned to lines
+    int nChunks = 4*std::max(QThread::idealThreadCount(), 1);
+    qint64 step = (m_size - pos)/nChunks + 1;
+    QVector<Chunk> chunks;
+    while (pos < m_size) {
+        qint64 end = std::min(pos + step, m_size);
+        if (end < m_size) {
+            const char* p = (const char*) std::memchr(m_data + end - 1, '\n', m_size - end + 1);
+            end = p ? p - m_data + 1 : m_size;
+        }
+        chunks << Chunk{pos, end, 0, 0, -1};
+        pos = end;
+    }
+
+    QtConcurrent::blockingMap(chunks, [this](Chunk& chunk) {
+        countRows(chunk);
+    });
+
+    int rows = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.row = rows;
+        rows += chunk.rows;
+    }
+
+    int nColumns = m_header.isEmpty() ? 0 : m_header.last().size();
+    if (nColumns == 0 && rows > 0) {
+        lineAt(chunks[0].begin, m_size, lineEnd, next);
+        nColumns = QByteArray::fromRawData(m_data + chunks[0].begin, lineEnd - chunks[0].begin).count(',') + 1;
+    }
+
+    m_lines.resize(rows);
+    m_columns.resize(nColumns);
+    for (QVector<double>& column : m_columns)
+        column.resize(rows);
+
+    QtConcurrent::blockingMap(chunks, [this](Chunk& chunk) {
+        parseRows(chunk);
+    });
+
+    for (const Chunk& chunk : chunks) {
+        if (chunk.rowError < 0) continue;
+        lineAt(m_lines[chunk.rowError], m_size, lineEnd, next);
+        QString line = QString::fromUtf8(m_data + m_lines[chunk.rowError], lineEnd - m_lines[chunk.rowError]);
+        throw QString("header and row %1 have a different number of elements\n").arg(chunk.rowError + 1) + line;
+    }
+}
+
+void TableCSV::clear()
+{
+    m_header.clear();
+    m_lines.clear();
+    m_columns.clear();
+
+    if (m_data) m_file.unmap((uchar*) m_data);
+    m_data = 0;
+    m_size = 0;
+    if (m_file.isOpen()) m_file.close();
+}
+
+QString TableCSV::text(int r, int c) const
+{
+    qint64 lineEnd, next;
+    lineAt(m_lines[r], m_size, lineEnd, next);
+    const char* p = m_data + m_lines[r];
+    const char* e = m_data + lineEnd;
+
+    for (int n = 0; n < c; ++n) {
+        const char* q = (const char*) std::memchr(p, ',', e - p);
+        if (!q) return QString();
+        p = q + 1;
+    }
+    const char* q = (const char*) std::memchr(p, ',', e - p);
+    if (!q) q = e;
+    return QString::fromUtf8(p, q - p);
+}
+
+// line at pos without the end of line, false at end
+bool TableCSV::lineAt(qint64 pos, qint64 end, qint64& lineEnd, qint64& next) const
+{
+    if (pos >= end) return false;
+
+    const char* p = (const char*) std::memchr(m_data + pos, '\n', end - pos);
+    if (p) {
+        lineEnd = p - m_data;
+        next = lineEnd + 1;
+    } else {
+        lineEnd = end;
+        next = end;
+    }
+    if (lineEnd > pos && m_data[lineEnd - 1] == '\r') lineEnd--;
+    return true;
+}
+
+void TableCSV::countRows(Chunk& chunk) const
+{
+    qint64 lineEnd, next;
+    for (qint64 pos = chunk.begin; lineAt(pos, chunk.end, lineEnd, next); pos = next)
+        if (lineEnd > pos) chunk.rows++;
+}
+
+void TableCSV::parseRows(Chunk& chunk)
+{
+    int nColumns = m_columns.size();
+    QVector<double*> columns(nColumns);
+    for (int c = 0; c < nColumns; ++c)
+        columns[c] = m_columns[c].data(); // not shared after resize
+    qint64* lines = m_lines.data();
+
+    qint64 lineEnd, next;
+    int row = chunk.row;
+    for (qint64 pos = chunk.begin; lineAt(pos, chunk.end, lineEnd, next); pos = next)
+    {
+        if (lineEnd == pos) continue;
+        lines[row] = pos;
+
+        const char* p = m_data + pos;
+        const char* e = m_data + lineEnd;
+        int c = 0;
+        while (true) {
+            const char* q = (const char*) std::memchr(p, ',', e - p);
+            if (!q) q = e;
+            if (c < nColumns) columns[c][row] = toDouble(p, q);
+            c++;
+            if (q == e) break;
+            p = q + 1;
+        }
+        if (c != nColumns && chunk.rowError < 0)
+            chunk.rowError = row;
+        row++;
+    }
+}
+
+
+} // namespace sp
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "SunPathLib/SunPathLib.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+namespace sp {
+
+
+//! TableCSV reads a comma separated file into columns of numbers.
+/*!
+ * The file is memory mapped and the lines after the header are parsed once in parallel chunks,
+ * a field which is not a number is stored as NaN.
+ * The mapping is kept until clear, so the text of a field is read without a copy of the lines.
+ */
+class SUNPATHLIB TableCSV
+{
+public:
+    TableCSV();
+    ~TableCSV();
+
+    void read(QString fileName, int headerLines); // throws QString
+    void clear();
+
+    int headerLines() const {return m_header.size();}
+    const QStringList& header(int n) const {return m_header[n];}
+
+    int rows() const {return m_lines.size();}
+    int columns() const {return m_columns.size();}
+    const QVector<double>& column(int c) const {return m_columns[c];}
+    QString text(int r, int c) const;
+
+private:
+    Q_DISABLE_COPY(TableCSV)
+
+    struct Chunk
+    {
+        qint64 begin;
+        qint64 end;
+        int rows;
+        int row; // first row
+        int rowError; // first row with a wrong number of fields, -1 if none
+    };
+
+    void countRows(Chunk& chunk) const;
+    void parseRows(Chunk& chunk);
+    bool lineAt(qint64 pos, qint64 end, qint64& lineEnd, qint64& next) const;
+
+    QFile m_file;
+    const char* m_data;
+    qint64 m_size;
+
+    QVector<QStringList> m_header;
+    QVector<qint64> m_lines; // begins of rows
+    QVector<QVector<double>> m_columns;
+};
+
+
+} // namespace sp
@@ -6,6 +6,12 @@
 
 namespace sp {
 
+struct MatrixNR::Factorization
+{
+    QVector<double> data; // shared copy of elements, detached by changes
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+};
+
 MatrixNR::MatrixNR(int rows, int columns):
     Matrix<double>(rows, columns)
 {
@@ -27,22 +33,66 @@ QVector<double> MatrixNR::multiply(const QVector<double>& vector)
     return ans;
 }
 
-QVector<double> MatrixNR::solve(const QVector<double>& vector)
+/*!
+ * Returns the factorization of the current elements.
+ * It is recomputed only if the elements differ from the factorized ones,
+ * the comparison is cheap while the data is still shared.
+ */
+const MatrixNR::Factorization& MatrixNR::factorization()
 {
+    if (m_factorization && m_factorization->data == m_data)
+        return *m_factorization;
+
     using namespace Eigen;
 
+    const QVector<double>& data = m_data; // without detaching
     int size = m_rows;
     MatrixXd mat(size, size);
+    for (int r = 0; r < size; ++r)
+        for (int c = 0; c < size; ++c)
+            mat(r, c) = data[index(r, c)];
+
+    auto f = std::make_shared<Factorization>();
+    f->data = m_data;
+    f->qr.compute(mat);
+    m_factorization = f;
+    return *f;
+}
+
+QVector<double> MatrixNR::solve(const QVector<double>& vector)
+{
+    using namespace Eigen;
+
+    const Factorization& f = factorization();
+
+    int size = m_rows;
     VectorXd vec(size);
+    for (int r = 0; r < size; ++r)
+        vec[r] = vector[r];
 
+    vec = f.qr.solve(vec);
+
+    QVector<double> ans(size);
     for (int r = 0; r < size; ++r)
-        for (int c = 0; c < size; ++c)
-            mat(r, c) = (*this)(r, c);
+        ans[r] = vec[r];
+    return ans;
+}
+
+/*!
+ * Solves the system with the transposed matrix.
+ */
+QVector<double> MatrixNR::solveTransposed(const QVector<double>& vector)
+{
+    using namespace Eigen;
+
+    const Factorization& f = factorization();
 
+    int size = m_rows;
+    VectorXd vec(size);
     for (int r = 0; r < size; ++r)
         vec[r] = vector[r];
 
-    vec = mat.colPivHouseholderQr().solve(vec);
+    vec = f.qr.transpose().solve(vec);
 
     QVector<double> ans(size);
     for (int r = 0; r < size; ++r)
@@ -50,19 +100,37 @@ QVector<double> MatrixNR::solve(const QVector<double>& vector)
     return ans;
 }
 
-void MatrixNR::invert()
+MatrixNR MatrixNR::solve(const MatrixNR& matrix)
 {
     using namespace Eigen;
 
+    const Factorization& f = factorization();
+
     int size = m_rows;
-    MatrixXd mat(size, size);
+    int columns = matrix.columns();
+    MatrixXd mat(size, columns);
+    for (int r = 0; r < size; ++r)
+        for (int c = 0; c < columns; ++c)
+            mat(r, c) = matrix(r, c);
 
-    for (int r = 0; r < size; r++)
-        for (int c = 0; c < size; c++)
-            mat(r, c) = (*this)(r, c);
+    mat = f.qr.solve(mat);
+
+    MatrixNR ans(size, columns);
+    for (int r = 0; r < size; ++r)
+        for (int c = 0; c < columns; ++c)
+            ans(r, c) = mat(r, c);
+    return ans;
+}
+
+void MatrixNR::invert()
+{
+    using namespace Eigen;
+
+    int size = m_rows;
+    const Factorization& f = factorization();
 
 //    mat = mat.inverse(); // worse
-    mat = mat.colPivHouseholderQr().solve(MatrixXd::Identity(size, size)); // better
+    MatrixXd mat = f.qr.solve(MatrixXd::Identity(size, size)); // better
 
     for (int r = 0; r < size; r++)
         for (int c = 0; c < m_columns; c++)
@@ -2,6 +2,8 @@
 
 #include "SunPathLib/math/matrices/Matrix.h"
 
+#include <memory>
+
 namespace sp {
 
 class SUNPATHLIB MatrixNR: public Matrix<double>
@@ -10,9 +12,19 @@ public:
     MatrixNR(int rows = 0, int columns = 0);
 
     QVector<double> multiply(const QVector<double>& vector);
+
+    // the factorization is computed once and reused while the elements are not changed
     QVector<double> solve(const QVector<double>& vector);
+    QVector<double> solveTransposed(const QVector<double>& vector);
+    MatrixNR solve(const MatrixNR& matrix); // for each column
 
     void invert();
+
+private:
+    struct Factorization;
+    const Factorization& factorization();
+
+    std::shared_ptr<const Factorization> m_factorization;
 };
 
 } // namespace sp
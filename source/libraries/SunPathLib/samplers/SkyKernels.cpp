@@ -26,6 +26,41 @@ double SkyKernelPolyharmonic::operator()(const SkyNode& sn, const vec3d& r) cons
     }
 }
 
+/*!
+ * Same as operator() for n vectors, the powers are integer for vectorization.
+ */
+void SkyKernelPolyharmonic::evaluate(const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans) const
+{
+    const double vx = sn.v.x;
+    const double vy = sn.v.y;
+    const double vz = sn.v.z;
+
+    if (order%2 == 1) {
+        for (int i = 0; i < n; ++i) {
+            double dx = vx - x[i];
+            double dy = vy - y[i];
+            double dz = vz - z[i];
+            double d = std::sqrt(dx*dx + dy*dy + dz*dz);
+            double rho = d;
+            for (int k = 1; k < order; ++k)
+                rho *= d;
+            ans[i] = rho;
+        }
+    } else {
+        const int half = order/2;
+        for (int i = 0; i < n; ++i) {
+            double dx = vx - x[i];
+            double dy = vy - y[i];
+            double dz = vz - z[i];
+            double d2 = dx*dx + dy*dy + dz*dz;
+            double rho = 1.;
+            for (int k = 0; k < half; ++k)
+                rho *= d2;
+            ans[i] = rho > 0. ? rho*std::log(rho) : 0.;
+        }
+    }
+}
+
 //SkyKernel* sk = new SkyKernelPolyharmonic(7);
 // without virtual, faster?
 //double x = sk->kernel(SkyNode(), vec3d::Zero);
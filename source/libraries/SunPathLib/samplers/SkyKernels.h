@@ -6,30 +6,46 @@ namespace sp {
 
 
 typedef double (*KernelFunc)(void* k, const SkyNode& sn, const vec3d& r);
+typedef void (*KernelsFunc)(void* k, const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans);
 
 template<class T>
 inline double kernelFuncT(void* k, const SkyNode& sn, const vec3d& r) {
     return (*(T*)k)(sn, r);
 }
 
+// for kernels without own batch
+template<class T>
+inline void kernelsFuncT(void* k, const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans) {
+    for (int i = 0; i < n; ++i)
+        ans[i] = (*(T*)k)(sn, vec3d(x[i], y[i], z[i]));
+}
+
+template<class T>
+inline void kernelsBatchT(void* k, const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans) {
+    ((T*)k)->evaluate(sn, x, y, z, n, ans);
+}
+
 struct SUNPATHLIB SkyKernel
 {
-    SkyKernel() {kf = kernelFuncT<SkyKernel>;}
+    SkyKernel() {kf = kernelFuncT<SkyKernel>; kfs = kernelsFuncT<SkyKernel>;}
     KernelFunc kf;
+    KernelsFunc kfs;
     inline double kernel(const SkyNode& sn, const vec3d& r) {return kf(this, sn, r);}
+    inline void kernels(const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans) {kfs(this, sn, x, y, z, n, ans);}
     double operator()(const SkyNode& /*sn*/, const vec3d& /*r*/) {return 0.;}
 };
 
 struct SUNPATHLIB SkyKernelGaussian3D: SkyKernel
 {
-    SkyKernelGaussian3D() {kf = kernelFuncT<SkyKernelGaussian3D>;}
+    SkyKernelGaussian3D() {kf = kernelFuncT<SkyKernelGaussian3D>; kfs = kernelsFuncT<SkyKernelGaussian3D>;}
     double operator()(const SkyNode& sn, const vec3d& r) const;
 };
 
 struct SUNPATHLIB SkyKernelPolyharmonic: SkyKernel
 {
-    SkyKernelPolyharmonic(int order): order(order) {kf = kernelFuncT<SkyKernelPolyharmonic>;}
+    SkyKernelPolyharmonic(int order): order(order) {kf = kernelFuncT<SkyKernelPolyharmonic>; kfs = kernelsBatchT<SkyKernelPolyharmonic>;}
     double operator()(const SkyNode& sn, const vec3d& r) const;
+    void evaluate(const SkyNode& sn, const double* x, const double* y, const double* z, int n, double* ans) const;
 
     int order;
 };
@@ -6,22 +6,22 @@
 namespace sp {
 
 
-struct SkyKernelLocalized: SunFunctor
+struct SkyKernelNode: SunFunctor
 {
-    SkyKernelLocalized(SkyKernel* k, QVector<SkyNode>& nodes, QVector<double> ampls):
+    SkyKernelNode(SkyKernel* k, const SkyNode& node):
         k(k),
-        nodes(nodes),
-        ampls(ampls)
+        node(node)
     {}
     SkyKernel* k;
-    QVector<SkyNode>& nodes;
-    QVector<double> ampls;
+    SkyNode node;
     double operator()(const vec3d& s) const {
         if (s.z <= 0.) return 0.;
-        double ans = 0.;
-        for (int n = 0; n < nodes.size(); n++)
-            ans += ampls[n]*k->kernel(nodes[n], s);
-        return ans;
+        return k->kernel(node, s);
+    }
+    void evaluate(const double* x, const double* y, const double* z, int n, double* ans) const {
+        k->kernels(node, x, y, z, n, ans);
+        for (int i = 0; i < n; ++i)
+            if (z[i] <= 0.) ans[i] = 0.;
     }
 };
 
@@ -88,15 +88,7 @@ void SunSpatial::setValues(const SunFunctor& sf)
 
 void SunSpatial::setValues(SunTemporal& sunTemporal)
 {  
-    QVector<double> overlapsW;
-    int pMax = m_skyNodes.size();
-    for (int p = 0; p < pMax; p++) {
-        QVector<double> values(pMax, 0.);
-        values[p] = 1.;
-        QVector<double> amplitudes = m_matrixK.solve(values);
-        SkyKernelLocalized sk(m_kernel.get(), m_skyNodes, amplitudes);
-        overlapsW << sunTemporal.integrateWeighted(sk);
-    }
+    QVector<double> overlapsW = findOverlaps(sunTemporal);
 
 //    int nMax = m_skyNodes.size();
 //    MatrixNR matrixKK(nMax, nMax);
@@ -146,17 +138,7 @@ void SunSpatial::setValues(SunTemporal& sunTemporal)
 
 void SunSpatial::setWeights(SunTemporal& sunTemporal, bool normalize)
 {
-    QVector<double> overlaps;
-    int pMax = m_skyNodes.size();
-    for (int p = 0; p < pMax; p++) {
-        QVector<double> values(pMax, 0.);
-        values[p] = 1.;
-        QVector<double> amplitudes = m_matrixK.solve(values);
-        SkyKernelLocalized sk(m_kernel.get(), m_skyNodes, amplitudes);
-        overlaps << sunTemporal.integrateWeighted(sk);
-    }
-
-    QVector<double> weights = overlaps;
+    QVector<double> weights = findOverlaps(sunTemporal);
     if (normalize) {
         double wTotal = 0.;
         for (double w : weights) wTotal += w;
@@ -167,6 +149,26 @@ void SunSpatial::setWeights(SunTemporal& sunTemporal, bool normalize)
     m_weights = weights;
 }
 
+/*!
+ * Returns the weighted integrals of the cardinal functions of nodes.
+ * The cardinal function of node p has the amplitudes K^-1 e_p,
+ * so its integral is the p-th component of K^-T g
+ * with g the integrals of the kernels of nodes (one factorization of K).
+ */
+QVector<double> SunSpatial::findOverlaps(SunTemporal& sunTemporal)
+{
+    QVector<SkyKernelNode> functors;
+    for (const SkyNode& sn : m_skyNodes)
+        functors << SkyKernelNode(m_kernel.get(), sn);
+
+    QVector<const SunFunctor*> sfs;
+    for (const SkyKernelNode& sk : functors)
+        sfs << &sk;
+
+    QVector<double> overlapsK = sunTemporal.integrateWeighted(sfs);
+    return m_matrixK.solveTransposed(overlapsK);
+}
+
 double SunSpatial::interpolate(const vec3d& v) const
 {
     double ans = 0.;
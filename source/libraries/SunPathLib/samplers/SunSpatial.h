@@ -43,6 +43,8 @@ public:
     void setInfo(QString info) {m_info = info;}
 
 protected:
+    QVector<double> findOverlaps(SunTemporal& sunTemporal);
+
     QSharedPointer<SunCalculator> m_calculator;
     QScopedPointer<SkyKernel> m_kernel;
     QString m_info;
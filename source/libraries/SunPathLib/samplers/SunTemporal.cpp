@@ -1,5 +1,10 @@
 #include "SunTemporal.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include <QtConcurrentMap>
+
 #include "SunPathLib/math/sampling/Summator.h"
 #include "SunPathLib/math/sampling/Interpolator.h"
 
@@ -44,6 +49,18 @@ void SunTemporal::setTimeStamps(const QVector<TimeStamp>& timeStamps)
 {
     m_timeStamps = timeStamps;
     m_timeStepH = timeStamps[0].t.msecsTo(timeStamps[1].t)/1000./3600.;
+
+    int nMax = m_timeStamps.size();
+    m_sx.resize(nMax);
+    m_sy.resize(nMax);
+    m_sz.resize(nMax);
+    for (int n = 0; n < nMax; ++n) {
+        const vec3d& v = m_timeStamps[n].s;
+        m_sx[n] = v.x;
+        m_sy[n] = v.y;
+        m_sz[n] = v.z;
+    }
+    m_coefficients.clear();
 }
 
 void SunTemporal::setData(const QVector<double>& data)
@@ -59,13 +76,20 @@ void SunTemporal::setData(const QVector<double>& data)
         points << vec2d(m_timeStamps[n].tc, sum.result());
     }
     m_interpolator->setData(points);
+
+    // trapezoidal rule, each stamp ends one interval and starts the next
+    m_coefficients.fill(0., m_timeStamps.size());
+    for (int n = 1; n < m_timeStamps.size(); ++n) {
+        double w = m_data[n - 1]*m_timeStepH/2.;
+        m_coefficients[n - 1] += w;
+        m_coefficients[n] += w;
+    }
 }
 
 void SunTemporal::setData(const SunFunctor& sf)
 {
-    QVector<double> temp;
-    for (const TimeStamp& ts : m_timeStamps)
-        temp << sf(ts.s);
+    QVector<double> temp(m_timeStamps.size());
+    sf.evaluate(m_sx.data(), m_sy.data(), m_sz.data(), temp.size(), temp.data());
 
     QVector<double> data;
     for (int n = 1; n < temp.size(); ++n)
@@ -109,15 +133,29 @@ double SunTemporal::average(QDateTime tA, QDateTime tB) const
     return (yB - yA)/(xB - xA);
 }
 
+/*!
+ * Returns the integral of data weighted with \a sf.
+ * The functor is evaluated on blocks of the stored sun vectors.
+ */
 double SunTemporal::integrateWeighted(const SunFunctor& sf) const
 {
+    const int blockSize = 1024;
+    double values[blockSize];
+
     Summator sum;
-    for (int n = 1; n < m_timeStamps.size(); ++n) {
-        double w = m_data[n - 1];
-        double f = sf(m_timeStamps[n - 1].s) + sf(m_timeStamps[n].s);
-        sum += w*f/2.;
+    int nMax = m_coefficients.size();
+    for (int nA = 0; nA < nMax; nA += blockSize)
+    {
+        int m = std::min(blockSize, nMax - nA);
+        sf.evaluate(m_sx.data() + nA, m_sy.data() + nA, m_sz.data() + nA, m, values);
+
+        const double* cs = m_coefficients.data() + nA;
+        double s = 0.;
+        for (int i = 0; i < m; ++i)
+            s += cs[i]*values[i];
+        sum += s;
     }
-    return sum.result()*m_timeStepH;
+    return sum.result();
 
     // derivatives
 //    QVector<double> fs;
@@ -136,5 +174,17 @@ double SunTemporal::integrateWeighted(const SunFunctor& sf) const
 //    return sum.result()*m_timeStepH;
 }
 
+QVector<double> SunTemporal::integrateWeighted(const QVector<const SunFunctor*>& sfs) const
+{
+    QVector<double> ans(sfs.size());
+    double* values = ans.data();
+    QVector<int> indices(sfs.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(indices, [&](int n) {
+        values[n] = integrateWeighted(*sfs[n]);
+    });
+    return ans;
+}
+
 
 } // namespace sp
@@ -34,6 +34,7 @@ public:
     double average(QDateTime tA, QDateTime tB) const;
 
     double integrateWeighted(const SunFunctor& sf) const;
+    QVector<double> integrateWeighted(const QVector<const SunFunctor*>& sfs) const; // in parallel
 
 protected:
     QSharedPointer<SunCalculator> m_calculator;
@@ -41,6 +42,12 @@ protected:
     double m_timeStepH;
     QVector<double> m_data;
     QSharedPointer<InterpolatorLinear> m_interpolator;
+
+    // sun vectors of time stamps by components
+    QVector<double> m_sx;
+    QVector<double> m_sy;
+    QVector<double> m_sz;
+    QVector<double> m_coefficients; // of time stamps for integrateWeighted
 };
 
 
@@ -8,6 +8,7 @@ include(../config.pri)
 CONFIG += object_parallel_to_source
 
 QT += printsupport # for customplot
+QT += concurrent # for SunTemporal
 
 gcc {
     QMAKE_CXXFLAGS += -Wno-deprecated-declarations # for customplot
@@ -36,14 +37,17 @@ HEADERS += \
     DistMesh/helper.h \
     DistMesh/triangulation.h \
     DistMesh/utils.h \
+    math/1D/AliasTable.h \
     math/1D/Grid.h \
     math/1D/Interval.h \
     math/1D/IntervalPeriodic.h \
+    math/1D/InverseCDF.h \
     math/2D/Box2D.h \
     math/2D/Interpolation2D.h \
     math/2D/Matrix2D.h \
     math/2D/vec2d.h \
     math/2D/vec2i.h \
+    math/3D/BVH.h \
     math/3D/Box3D.h \
     math/3D/Matrix4x4.h \
     math/3D/Ray.h \
@@ -69,12 +73,15 @@ SOURCES += \
     DistMesh/functional.cpp \
     DistMesh/triangulation.cpp \
     DistMesh/utils.cpp \
+    math/1D/AliasTable.cpp \
     math/1D/Grid.cpp \
     math/1D/Interval.cpp \
     math/1D/IntervalPeriodic.cpp \
+    math/1D/InverseCDF.cpp \
     math/2D/Box2D.cpp \
     math/2D/vec2d.cpp \
     math/2D/vec2i.cpp \
+    math/3D/BVH.cpp \
     math/3D/Box3D.cpp \
     math/3D/Matrix4x4.cpp \
     math/3D/Transform.cpp \
@@ -103,6 +110,7 @@ HEADERS += \
     SunPathLib/data/SkyModel.h \
     SunPathLib/data/SkyModelPI.h \
     SunPathLib/data/SunFunctor.h \
+    SunPathLib/data/TableCSV.h \
     SunPathLib/math/geometry/Interval.h \
     SunPathLib/math/geometry/vec2d.h \
     SunPathLib/math/geometry/vec3d.h \
@@ -133,6 +141,7 @@ SOURCES += \
     SunPathLib/data/SkyModel.cpp \
     SunPathLib/data/SkyModelPI.cpp \
     SunPathLib/data/SunFunctor.cpp \
+    SunPathLib/data/TableCSV.cpp \
     SunPathLib/math/geometry/Interval.cpp \
     SunPathLib/math/geometry/vec2d.cpp \
     SunPathLib/math/geometry/vec3d.cpp \
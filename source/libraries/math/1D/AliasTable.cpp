@@ -0,0 +1,74 @@
+#include "AliasTable.h"
+
+
+/*!
+ * Builds the table for non-negative \a weights (Vose's variant).
+ */
+void AliasTable::build(const std::vector<double>& weights)
+{
+    clear();
+
+    int n = int(weights.size());
+    double sum = 0.;
+    for (double w : weights)
+        sum += w;
+    if (n == 0 || sum <= 0.) return;
+
+    m_probabilities.resize(n);
+    m_aliases.resize(n);
+
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i]*n/sum;
+        if (scaled[i] < 1.)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+
+        m_probabilities[s] = scaled[s];
+        m_aliases[s] = l;
+
+        scaled[l] -= 1. - scaled[s];
+        if (scaled[l] < 1.) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // remaining slots are full up to rounding
+    for (int i : large) {
+        m_probabilities[i] = 1.;
+        m_aliases[i] = i;
+    }
+    for (int i : small) {
+        m_probabilities[i] = 1.;
+        m_aliases[i] = i;
+    }
+}
+
+void AliasTable::clear()
+{
+    m_probabilities.clear();
+    m_aliases.clear();
+}
+
+/*!
+ * Returns an index for a uniform \a u, the fraction left after picking the slot decides for the alias.
+ */
+int AliasTable::sample(double u) const
+{
+    int n = size();
+    double s = u*n;
+    int i = int(s);
+    if (i >= n) i = n - 1;
+    return s - i < m_probabilities[i] ? i : m_aliases[i];
+}
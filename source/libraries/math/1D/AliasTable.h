@@ -0,0 +1,28 @@
+#pragma once
+
+#include "libraries/TonatiuhLibraries.h"
+
+#include <vector>
+
+
+//! AliasTable samples an index with probability proportional to its weight in constant time.
+/*!
+ * Walker's alias method: each slot keeps a probability and an alternative index.
+ */
+class TONATIUH_LIBRARIES AliasTable
+{
+public:
+    AliasTable() {}
+
+    void build(const std::vector<double>& weights);
+    void clear();
+
+    int size() const {return int(m_probabilities.size());}
+    bool isEmpty() const {return m_probabilities.empty();}
+
+    int sample(double u) const; // u in [0, 1)
+
+private:
+    std::vector<double> m_probabilities;
+    std::vector<int> m_aliases;
+};
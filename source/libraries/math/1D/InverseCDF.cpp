@@ -0,0 +1,46 @@
+#include "InverseCDF.h"
+
+
+/*!
+ * Integrates \a pdfs with the trapezoidal rule and inverts the cdf at \a size uniform levels.
+ * Place a knot at each discontinuity of the pdf.
+ */
+void InverseCDF::build(const std::vector<double>& xs, const std::vector<double>& pdfs, int size)
+{
+    clear();
+
+    int n = int(xs.size());
+    if (n < 2 || int(pdfs.size()) != n || size < 2) return;
+
+    std::vector<double> cdf(n, 0.);
+    for (int i = 1; i < n; ++i)
+        cdf[i] = cdf[i - 1] + (pdfs[i - 1] + pdfs[i])*(xs[i] - xs[i - 1])/2.;
+
+    double total = cdf.back();
+    if (total <= 0.) return;
+
+    m_xs.resize(size);
+    int i = 1;
+    for (int k = 0; k < size; ++k)
+    {
+        double c = total*k/(size - 1);
+        while (i < n - 1 && cdf[i] < c) ++i;
+        double dc = cdf[i] - cdf[i - 1];
+        double t = dc > 0. ? (c - cdf[i - 1])/dc : 0.;
+        if (t > 1.) t = 1.;
+        m_xs[k] = xs[i - 1] + t*(xs[i] - xs[i - 1]);
+    }
+}
+
+/*!
+ * Returns 0 if the table is empty (e.g. pdf concentrated at 0).
+ */
+double InverseCDF::sample(double u) const
+{
+    int n = int(m_xs.size());
+    if (n == 0) return 0.;
+    double s = u*(n - 1);
+    int k = int(s);
+    if (k >= n - 1) return m_xs.back();
+    return m_xs[k] + (s - k)*(m_xs[k + 1] - m_xs[k]);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "libraries/TonatiuhLibraries.h"
+
+#include <vector>
+
+
+//! InverseCDF samples a tabulated distribution with one lookup.
+/*!
+ * The cumulative distribution of a pdf given at knots is inverted
+ * at uniform levels, a sample is interpolated between two of them.
+ */
+class TONATIUH_LIBRARIES InverseCDF
+{
+public:
+    InverseCDF() {}
+
+    // pdf (not normalized) at increasing xs
+    void build(const std::vector<double>& xs, const std::vector<double>& pdfs, int size = 4096);
+    void clear() {m_xs.clear();}
+
+    bool isEmpty() const {return m_xs.empty();}
+
+    double sample(double u) const; // u in [0, 1]
+
+private:
+    std::vector<double> m_xs; // x at uniform levels of cdf
+};
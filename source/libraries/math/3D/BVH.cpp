@@ -0,0 +1,150 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace {
+    const int BinsMax = 16;
+
+    // depth of a tree with median splits
+    int depthMedian(int count)
+    {
+        int ans = 0;
+        for (int c = 1; c < count; c *= 2) ans++;
+        return ans;
+    }
+}
+
+
+void BVH::build(const std::vector<Box3D>& boxes, int leafSize)
+{
+    clear();
+    if (boxes.empty()) return;
+    m_leafSize = std::max(leafSize, 1);
+
+    std::vector<BuildItem> items;
+    items.reserve(boxes.size());
+    for (int n = 0; n < int(boxes.size()); ++n)
+        items.push_back({boxes[n], boxes[n].center(), n});
+
+    m_nodes.reserve(2*boxes.size());
+    build(items, 0, items.size(), 0);
+    assert(m_depth <= DepthMax);
+
+    m_indices.reserve(items.size());
+    for (const BuildItem& item : items)
+        m_indices.push_back(item.index);
+}
+
+void BVH::clear()
+{
+    m_nodes.clear();
+    m_indices.clear();
+    m_depth = 0;
+}
+
+int BVH::build(std::vector<BuildItem>& items, int begin, int end, int depth)
+{
+    int n = m_nodes.size();
+    m_nodes.push_back(BVHNode());
+
+    Box3D box;
+    Box3D boxCenters;
+    for (int i = begin; i < end; ++i) {
+        box << items[i].box;
+        boxCenters << items[i].center;
+    }
+    m_nodes[n].box = box;
+    m_nodes[n].offset = begin;
+    m_nodes[n].count = end - begin;
+    m_nodes[n].axis = 0;
+    m_depth = std::max(m_depth, depth);
+
+    int count = end - begin;
+    if (count == 1) return n;
+
+    vec3d extent = boxCenters.size();
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+    if (extent[axis] <= 0.) {
+        if (count <= m_leafSize) return n;
+        axis = -1; // coincident centers
+    }
+
+    // splits keep depth + depthMedian(count) <= DepthMax for the children,
+    // a median split always does
+    int middle = (begin + end)/2;
+    bool isSAH = false;
+    if (axis >= 0)
+    {
+        // binned surface area heuristic
+        int nBins = std::min(BinsMax, count);
+        double cMin = boxCenters.min()[axis];
+        double scale = nBins/extent[axis];
+        int binCounts[BinsMax] = {0};
+        Box3D binBoxes[BinsMax];
+        for (int i = begin; i < end; ++i) {
+            int b = std::min(int((items[i].center[axis] - cMin)*scale), nBins - 1);
+            binCounts[b]++;
+            binBoxes[b] << items[i].box;
+        }
+
+        double areasRight[BinsMax];
+        int countsRight[BinsMax];
+        Box3D boxRight;
+        int countRight = 0;
+        for (int b = nBins - 1; b > 0; --b) {
+            boxRight << binBoxes[b];
+            countRight += binCounts[b];
+            areasRight[b] = boxRight.area();
+            countsRight[b] = countRight;
+        }
+
+        double costBest = gcf::infinity;
+        int binBest = -1;
+        Box3D boxLeft;
+        int countLeft = 0;
+        for (int b = 1; b < nBins; ++b) {
+            boxLeft << binBoxes[b - 1];
+            countLeft += binCounts[b - 1];
+            if (countLeft == 0 || countsRight[b] == 0) continue;
+            double cost = boxLeft.area()*countLeft + areasRight[b]*countsRight[b];
+            if (cost < costBest) {
+                costBest = cost;
+                binBest = b;
+            }
+        }
+
+        double area = box.area();
+        if (area > 0.) costBest = 1. + costBest/area;
+        if (count <= m_leafSize && (binBest < 0 || costBest >= count))
+            return n;
+
+        if (binBest > 0 && depth + 1 + depthMedian(std::max(count - countsRight[binBest], countsRight[binBest])) <= DepthMax) {
+            auto it = std::partition(items.begin() + begin, items.begin() + end,
+                [=](const BuildItem& item) {
+                    return std::min(int((item.center[axis] - cMin)*scale), nBins - 1) < binBest;
+                }
+            );
+            middle = it - items.begin();
+            isSAH = true;
+        }
+    }
+    if (axis >= 0 && !isSAH)
+    {
+        std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+            [=](const BuildItem& a, const BuildItem& b) {return a.center[axis] < b.center[axis];}
+        );
+    }
+
+    if (middle == begin || middle == end) middle = (begin + end)/2;
+
+    m_nodes[n].count = 0;
+    m_nodes[n].axis = std::max(axis, 0);
+    build(items, begin, middle, depth + 1);
+    int second = build(items, middle, end, depth + 1);
+    m_nodes[n].offset = second;
+    return n;
+}
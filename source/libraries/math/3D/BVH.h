@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+
+#include "libraries/math/3D/Box3D.h"
+#include "libraries/math/3D/Ray.h"
+
+
+struct TONATIUH_LIBRARIES BVHNode
+{
+    Box3D box;
+    int offset; // first index for leaf, second child for inner node
+    int count; // number of primitives for leaf, 0 for inner node
+    int axis; // split axis for inner node
+
+    bool isLeaf() const {return count > 0;}
+};
+
+
+//! BVH is a bounding volume hierarchy over a set of boxes
+/*!
+ * The tree is built with the surface area heuristic evaluated on binned centroids.
+ * The nodes are stored in a flat array in depth-first order:
+ * the first child follows its parent, the second child is at offset.
+ * Leaves refer to a range in indices().
+ * The depth is at most DepthMax, so the traversal stack has a fixed size.
+ */
+class TONATIUH_LIBRARIES BVH
+{
+public:
+    static const int DepthMax = 64;
+
+    BVH(): m_depth(0) {}
+    BVH(const std::vector<Box3D>& boxes, int leafSize = 4) {build(boxes, leafSize);}
+
+    void build(const std::vector<Box3D>& boxes, int leafSize = 4);
+    void clear();
+
+    bool isEmpty() const {return m_nodes.empty();}
+    int depth() const {return m_depth;}
+    Box3D box() const {return m_nodes.empty() ? Box3D() : m_nodes[0].box;}
+    const std::vector<BVHNode>& nodes() const {return m_nodes;}
+    const std::vector<int>& indices() const {return m_indices;}
+
+    // nearest hit, f(index, ray) decreases ray.tMax for a hit
+    template<class F>
+    bool intersect(const Ray& ray, F& f) const;
+
+    // any hit, stops at the first primitive with f(index, ray) true
+    template<class F>
+    bool intersectP(const Ray& ray, F& f) const;
+
+private:
+    struct BuildItem
+    {
+        Box3D box;
+        vec3d center;
+        int index;
+    };
+
+    int build(std::vector<BuildItem>& items, int begin, int end, int depth);
+
+    std::vector<BVHNode> m_nodes;
+    std::vector<int> m_indices;
+    int m_leafSize;
+    int m_depth; // of the deepest leaf
+};
+
+
+template<class F>
+bool BVH::intersect(const Ray& ray, F& f) const
+{
+    if (m_nodes.empty()) return false;
+
+    bool isHit = false;
+    int stack[DepthMax];
+    int stackSize = 0;
+    int n = 0;
+    while (true)
+    {
+        const BVHNode& node = m_nodes[n];
+        if (node.box.intersect(ray))
+        {
+            if (node.isLeaf())
+            {
+                for (int i = node.offset; i < node.offset + node.count; ++i)
+                    if (f(m_indices[i], ray)) isHit = true;
+            }
+            else
+            {
+                // front to back
+                if (ray.direction()[node.axis] < 0.) {
+                    stack[stackSize++] = n + 1;
+                    n = node.offset;
+                } else {
+                    stack[stackSize++] = node.offset;
+                    n = n + 1;
+                }
+                continue;
+            }
+        }
+        if (stackSize == 0) break;
+        n = stack[--stackSize];
+    }
+    return isHit;
+}
+
+template<class F>
+bool BVH::intersectP(const Ray& ray, F& f) const
+{
+    if (m_nodes.empty()) return false;
+
+    int stack[DepthMax];
+    int stackSize = 0;
+    int n = 0;
+    while (true)
+    {
+        const BVHNode& node = m_nodes[n];
+        if (node.box.intersect(ray))
+        {
+            if (node.isLeaf())
+            {
+                for (int i = node.offset; i < node.offset + node.count; ++i)
+                    if (f(m_indices[i], ray)) return true;
+            }
+            else
+            {
+                stack[stackSize++] = node.offset;
+                n = n + 1;
+                continue;
+            }
+        }
+        if (stackSize == 0) break;
+        n = stack[--stackSize];
+    }
+    return false;
+}
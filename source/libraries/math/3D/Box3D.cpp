@@ -33,6 +33,13 @@ double Box3D::volume() const
     return d.x*d.y*d.z;
 }
 
+double Box3D::area() const
+{
+    if (!(m_a.x <= m_b.x && m_a.y <= m_b.y && m_a.z <= m_b.z)) return 0.;
+    vec3d d = m_b - m_a;
+    return 2.*(d.x*d.y + d.y*d.z + d.z*d.x);
+}
+
 void Box3D::expandLimits(double delta)
 {
     vec3d v(delta, delta, delta);
@@ -16,6 +16,7 @@ struct TONATIUH_LIBRARIES Box3D
     vec3d size() const {return m_b - m_a;}
     vec3d center() const {return (m_a + m_b)/2.;}
     double volume() const;
+    double area() const;
 
     void expandLimits(double delta);
     void expand(const vec3d& p);
@@ -4,61 +4,94 @@
 #include "Ray.h"
 #include "Box3D.h"
 
-const Transform Transform::Identity(new Matrix4x4);
+const Transform Transform::Identity;
 
 
-Transform::Transform():
-    m_mdir(0), m_minv(0)
+Transform::Transform()
 {
-
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 4; ++j) {
+            m_mdir[i][j] = i == j ? 1. : 0.;
+            m_minv[i][j] = m_mdir[i][j];
+        }
 }
 
 Transform::Transform(
     double t00, double t01, double t02, double t03,
     double t10, double t11, double t12, double t13,
     double t20, double t21, double t22, double t23,
-    double t30, double t31, double t32, double t33
+    double, double, double, double
 )
 {
-    m_mdir = std::make_shared<Matrix4x4>(
-        t00, t01, t02, t03,
-        t10, t11, t12, t13,
-        t20, t21, t22, t23,
-        t30, t31, t32, t33
-    );
-    m_minv = m_mdir->inversed();
+    double m[3][4] = {
+        {t00, t01, t02, t03},
+        {t10, t11, t12, t13},
+        {t20, t21, t22, t23}
+    };
+    setDirect(m);
 }
 
 Transform::Transform(double m[4][4])
 {
-    m_mdir = std::make_shared<Matrix4x4>(
-        m[0][0], m[0][1], m[0][2], m[0][3],
-        m[1][0], m[1][1], m[1][2], m[1][3],
-        m[2][0], m[2][1], m[2][2], m[2][3],
-        m[3][0], m[3][1], m[3][2], m[3][3]
-    );
-    m_minv = m_mdir->inversed();
+    setDirect(m);
 }
 
-Transform::Transform(Matrix4x4* m):
-    m_mdir(m),
-    m_minv(m->inversed())
+Transform::Transform(const Matrix4x4& m)
 {
-
+    setDirect(m.m);
 }
 
-Transform::Transform(const std::shared_ptr<Matrix4x4>& mdir):
-    m_mdir(mdir),
-    m_minv(mdir->inversed())
+// the last row is assumed to be 0 0 0 1
+void Transform::setDirect(const double m[3][4])
 {
-
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 4; ++j)
+            m_mdir[i][j] = m[i][j];
+
+    // inverse of the linear part by cofactors
+    const double* t0 = m[0];
+    const double* t1 = m[1];
+    const double* t2 = m[2];
+    double c00 = t1[1]*t2[2] - t1[2]*t2[1];
+    double c01 = t1[2]*t2[0] - t1[0]*t2[2];
+    double c02 = t1[0]*t2[1] - t1[1]*t2[0];
+    double det = t0[0]*c00 + t0[1]*c01 + t0[2]*c02;
+    double s = det != 0. ? 1./det : 0.;
+
+    m_minv[0][0] = c00*s;
+    m_minv[0][1] = (t0[2]*t2[1] - t0[1]*t2[2])*s;
+    m_minv[0][2] = (t0[1]*t1[2] - t0[2]*t1[1])*s;
+    m_minv[1][0] = c01*s;
+    m_minv[1][1] = (t0[0]*t2[2] - t0[2]*t2[0])*s;
+    m_minv[1][2] = (t0[2]*t1[0] - t0[0]*t1[2])*s;
+    m_minv[2][0] = c02*s;
+    m_minv[2][1] = (t0[1]*t2[0] - t0[0]*t2[1])*s;
+    m_minv[2][2] = (t0[0]*t1[1] - t0[1]*t1[0])*s;
+
+    // translation of the inverse
+    for (int i = 0; i < 3; ++i)
+        m_minv[i][3] = -(m_minv[i][0]*t0[3] + m_minv[i][1]*t1[3] + m_minv[i][2]*t2[3]);
+}
+
+Matrix4x4 Transform::getMatrix() const
+{
+    return Matrix4x4(
+        m_mdir[0][0], m_mdir[0][1], m_mdir[0][2], m_mdir[0][3],
+        m_mdir[1][0], m_mdir[1][1], m_mdir[1][2], m_mdir[1][3],
+        m_mdir[2][0], m_mdir[2][1], m_mdir[2][2], m_mdir[2][3],
+        0., 0., 0., 1.
+    );
 }
 
-Transform::Transform(const std::shared_ptr<Matrix4x4>& mdir, const std::shared_ptr<Matrix4x4>& minv):
-    m_mdir(mdir),
-    m_minv(minv)
+Transform Transform::inversed() const
 {
-
+    Transform ans;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 4; ++j) {
+            ans.m_mdir[i][j] = m_minv[i][j];
+            ans.m_minv[i][j] = m_mdir[i][j];
+        }
+    return ans;
 }
 
 vec3d Transform::getScales() const
@@ -66,9 +99,9 @@ vec3d Transform::getScales() const
     // https://math.stackexchange.com/questions/237369/given-this-transformation-matrix-how-do-i-decompose-it-into-translation-rotati/417813
     // polar decomposition
 
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
 
     return vec3d(
         vec3d(t0[0], t1[0], t2[0]).norm(),
@@ -80,25 +113,31 @@ vec3d Transform::getScales() const
 bool Transform::SwapsHandedness() const //?
 {
     double det =
-        m_mdir->m[0][0]*(m_mdir->m[1][1]*m_mdir->m[2][2] - m_mdir->m[1][2]*m_mdir->m[2][1]) -
-        m_mdir->m[0][1]*(m_mdir->m[1][0]*m_mdir->m[2][2] - m_mdir->m[1][2]*m_mdir->m[2][0]) +
-        m_mdir->m[0][2]*(m_mdir->m[1][0]*m_mdir->m[2][1] - m_mdir->m[1][1]*m_mdir->m[2][0]);
+        m_mdir[0][0]*(m_mdir[1][1]*m_mdir[2][2] - m_mdir[1][2]*m_mdir[2][1]) -
+        m_mdir[0][1]*(m_mdir[1][0]*m_mdir[2][2] - m_mdir[1][2]*m_mdir[2][0]) +
+        m_mdir[0][2]*(m_mdir[1][0]*m_mdir[2][1] - m_mdir[1][1]*m_mdir[2][0]);
     return det < 0.;
 }
 
 Transform Transform::operator*(const Transform& t) const
 {
-    return Transform(
-        multiply(*m_mdir, *t.m_mdir),
-        multiply(*t.m_minv, *m_minv)
-    );
+    Transform ans;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            ans.m_mdir[i][j] = m_mdir[i][0]*t.m_mdir[0][j] + m_mdir[i][1]*t.m_mdir[1][j] + m_mdir[i][2]*t.m_mdir[2][j];
+            ans.m_minv[i][j] = t.m_minv[i][0]*m_minv[0][j] + t.m_minv[i][1]*m_minv[1][j] + t.m_minv[i][2]*m_minv[2][j];
+        }
+        ans.m_mdir[i][3] += m_mdir[i][3];
+        ans.m_minv[i][3] += t.m_minv[i][3];
+    }
+    return ans;
 }
 
 vec3d Transform::transformPoint(const vec3d& p) const
 {
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
     return vec3d(
         t0[0]*p.x + t0[1]*p.y + t0[2]*p.z + t0[3],
         t1[0]*p.x + t1[1]*p.y + t1[2]*p.z + t1[3],
@@ -108,9 +147,9 @@ vec3d Transform::transformPoint(const vec3d& p) const
 
 vec3d Transform::transformVector(const vec3d& v) const
 {
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
     return vec3d(
         t0[0]*v.x + t0[1]*v.y + t0[2]*v.z,
         t1[0]*v.x + t1[1]*v.y + t1[2]*v.z,
@@ -121,9 +160,9 @@ vec3d Transform::transformVector(const vec3d& v) const
 //https://www.scratchapixel.com/lessons/mathematics-physics-for-computer-graphics/geometry/transforming-normals
 vec3d Transform::transformNormal(const vec3d& n) const
 {
-    const double* t0 = m_minv->m[0];
-    const double* t1 = m_minv->m[1];
-    const double* t2 = m_minv->m[2];
+    const double* t0 = m_minv[0];
+    const double* t1 = m_minv[1];
+    const double* t2 = m_minv[2];
     return vec3d(
         t0[0]*n.x + t1[0]*n.y + t2[0]*n.z,
         t0[1]*n.x + t1[1]*n.y + t2[1]*n.z,
@@ -133,9 +172,9 @@ vec3d Transform::transformNormal(const vec3d& n) const
 
 vec3d Transform::transformInverseNormal(const vec3d& n) const
 {
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
     return vec3d(
         t0[0]*n.x + t1[0]*n.y + t2[0]*n.z,
         t0[1]*n.x + t1[1]*n.y + t2[1]*n.z,
@@ -152,9 +191,9 @@ Ray Transform::transformDirect(const Ray& r) const
 //    ans.tMin = r.tMin;
 //    ans.tMax = r.tMax;
 //    return ans;
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
 
     const vec3d& p = r.origin;
     vec3d o(
@@ -169,9 +208,9 @@ Ray Transform::transformDirect(const Ray& r) const
         t1[0]*v.x + t1[1]*v.y + t1[2]*v.z,
         t2[0]*v.x + t2[1]*v.y + t2[2]*v.z
     );
-//    const double* ti0 = m_minv->m[0];
-//    const double* ti1 = m_minv->m[1];
-//    const double* ti2 = m_minv->m[2];
+//    const double* ti0 = m_minv[0];
+//    const double* ti1 = m_minv[1];
+//    const double* ti2 = m_minv[2];
 //    Vector3D d(
 //        ti0[0]*v.x + ti1[0]*v.y + ti2[0]*v.z,
 //        ti0[1]*v.x + ti1[1]*v.y + ti2[1]*v.z,
@@ -183,9 +222,9 @@ Ray Transform::transformDirect(const Ray& r) const
 
 Ray Transform::transformInverse(const Ray& r) const
 {
-    const double* t0 = m_minv->m[0];
-    const double* t1 = m_minv->m[1];
-    const double* t2 = m_minv->m[2];
+    const double* t0 = m_minv[0];
+    const double* t1 = m_minv[1];
+    const double* t2 = m_minv[2];
 
     const vec3d& p = r.origin;
     vec3d o(
@@ -200,9 +239,9 @@ Ray Transform::transformInverse(const Ray& r) const
         t1[0]*v.x + t1[1]*v.y + t1[2]*v.z,
         t2[0]*v.x + t2[1]*v.y + t2[2]*v.z
     );
-//    const double* ti0 = m_mdir->m[0];
-//    const double* ti1 = m_mdir->m[1];
-//    const double* ti2 = m_mdir->m[2];
+//    const double* ti0 = m_mdir[0];
+//    const double* ti1 = m_mdir[1];
+//    const double* ti2 = m_mdir[2];
 //    Vector3D d(
 //        ti0[0]*v.x + ti1[0]*v.y + ti2[0]*v.z,
 //        ti0[1]*v.x + ti1[1]*v.y + ti2[1]*v.z,
@@ -215,12 +254,12 @@ Ray Transform::transformInverse(const Ray& r) const
 //Point3D Transform::operator()(const Point3D& p) const
 //{
 //    Point3D ans(
-//        m_mdir->m[0][0]*p.x + m_mdir->m[0][1]*p.y + m_mdir->m[0][2]*p.z + m_mdir->m[0][3],
-//        m_mdir->m[1][0]*p.x + m_mdir->m[1][1]*p.y + m_mdir->m[1][2]*p.z + m_mdir->m[1][3],
-//        m_mdir->m[2][0]*p.x + m_mdir->m[2][1]*p.y + m_mdir->m[2][2]*p.z + m_mdir->m[2][3]
+//        m_mdir[0][0]*p.x + m_mdir[0][1]*p.y + m_mdir[0][2]*p.z + m_mdir[0][3],
+//        m_mdir[1][0]*p.x + m_mdir[1][1]*p.y + m_mdir[1][2]*p.z + m_mdir[1][3],
+//        m_mdir[2][0]*p.x + m_mdir[2][1]*p.y + m_mdir[2][2]*p.z + m_mdir[2][3]
 //    );
 
-//    double w = m_mdir->m[3][0]*p.x + m_mdir->m[3][1]*p.y + m_mdir->m[3][2]*p.z + m_mdir->m[3][3];
+//    double w = m_mdir[3][0]*p.x + m_mdir[3][1]*p.y + m_mdir[3][2]*p.z + m_mdir[3][3];
 //    if (w != 1.) return ans /= w;
 
 //    return ans;
@@ -229,17 +268,17 @@ Ray Transform::transformInverse(const Ray& r) const
 vec3d Transform::operator()(const vec3d& v) const
 {
     return vec3d(
-        m_mdir->m[0][0]*v.x + m_mdir->m[0][1]*v.y + m_mdir->m[0][2]*v.z,
-        m_mdir->m[1][0]*v.x + m_mdir->m[1][1]*v.y + m_mdir->m[1][2]*v.z,
-        m_mdir->m[2][0]*v.x + m_mdir->m[2][1]*v.y + m_mdir->m[2][2]*v.z
+        m_mdir[0][0]*v.x + m_mdir[0][1]*v.y + m_mdir[0][2]*v.z,
+        m_mdir[1][0]*v.x + m_mdir[1][1]*v.y + m_mdir[1][2]*v.z,
+        m_mdir[2][0]*v.x + m_mdir[2][1]*v.y + m_mdir[2][2]*v.z
     );
 }
 
 void Transform::operator()(const vec3d& v, vec3d& ans) const
 {
-    ans.x = m_mdir->m[0][0]*v.x + m_mdir->m[0][1]*v.y + m_mdir->m[0][2]*v.z;
-    ans.y = m_mdir->m[1][0]*v.x + m_mdir->m[1][1]*v.y + m_mdir->m[1][2]*v.z;
-    ans.z = m_mdir->m[2][0]*v.x + m_mdir->m[2][1]*v.y + m_mdir->m[2][2]*v.z;
+    ans.x = m_mdir[0][0]*v.x + m_mdir[0][1]*v.y + m_mdir[0][2]*v.z;
+    ans.y = m_mdir[1][0]*v.x + m_mdir[1][1]*v.y + m_mdir[1][2]*v.z;
+    ans.z = m_mdir[2][0]*v.x + m_mdir[2][1]*v.y + m_mdir[2][2]*v.z;
 }
 
 Ray Transform::operator()(const Ray& r) const
@@ -297,9 +336,9 @@ bool Transform::operator==(const Transform& t) const
 {
     if (this == &t) return true;
 
-    for (int i = 0; i < 4; ++i)
+    for (int i = 0; i < 3; ++i)
         for (int j = 0; j < 4; ++j)
-            if (!gcf::equals(m_mdir->m[i][j], t.m_mdir->m[i][j]))
+            if (!gcf::equals(m_mdir[i][j], t.m_mdir[i][j]))
                 return false;
 
     return true;
@@ -307,22 +346,7 @@ bool Transform::operator==(const Transform& t) const
 
 vec3d Transform::multVecMatrix(const vec3d& v) const
 {
-    vec3d ans;
-
-    const double* t0 = m_mdir->m[0];
-    const double* t1 = m_mdir->m[1];
-    const double* t2 = m_mdir->m[2];
-    const double* t3 = m_mdir->m[3];
-
-    double w = t3[0]*v[0] + t3[1]*v[1] + t3[2]*v[2] + t3[3];
-
-    if (w != 0.) {
-        ans[0] = (t0[0]*v[0] + t0[1]*v[1] + t0[2]*v[2] + t0[3])/w;
-        ans[1] = (t1[0]*v[0] + t1[1]*v[1] + t1[2]*v[2] + t1[3])/w;
-        ans[2] = (t2[0]*v[0] + t2[1]*v[1] + t2[2]*v[2] + t2[3])/w;
-    }
-
-    return ans;
+    return transformPoint(v); // affine, w = 1
 }
 
 vec3d Transform::multDirMatrix(const vec3d& src) const
@@ -333,9 +357,9 @@ vec3d Transform::multDirMatrix(const vec3d& src) const
     //if (SbMatrixP::isIdentity(this->matrix)) { dst = src; return dst; }
 
 
-    const double* t0 = (m_mdir->m)[0];
-    const double* t1 = (m_mdir->m)[1];
-    const double* t2 = (m_mdir->m)[2];
+    const double* t0 = m_mdir[0];
+    const double* t1 = m_mdir[1];
+    const double* t2 = m_mdir[2];
     // Copy the src vector, just in case src and dst is the same vector.
     dst[0] = src[0]*t0[0] + src[1]*t0[1] + src[2]*t0[2];
     dst[1] = src[0]*t1[0] + src[1]*t1[1] + src[2]*t1[2];
@@ -346,40 +370,37 @@ vec3d Transform::multDirMatrix(const vec3d& src) const
 
 Transform Transform::translate(double x, double y, double z)
 {
-    auto mdir = std::make_shared<Matrix4x4>(
-        1., 0., 0., x,
-        0., 1., 0., y,
-        0., 0., 1., z,
-        0., 0., 0., 1.
-    );
-
-    auto minv = std::make_shared<Matrix4x4>(
-        1., 0., 0., -x,
-        0., 1., 0., -y,
-        0., 0., 1., -z,
-        0., 0., 0., 1.
-    );
-
-    return Transform(mdir, minv);
+    Transform ans;
+    ans.m_mdir[0][3] = x;
+    ans.m_mdir[1][3] = y;
+    ans.m_mdir[2][3] = z;
+    ans.m_minv[0][3] = -x;
+    ans.m_minv[1][3] = -y;
+    ans.m_minv[2][3] = -z;
+    return ans;
 }
 
 Transform Transform::scale(double sx, double sy, double sz)
 {
-    auto mdir = std::make_shared<Matrix4x4>(
-        sx, 0., 0., 0.,
-        0., sy, 0., 0.,
-        0., 0., sz, 0.,
-        0., 0., 0., 1.
-    );
-
-    auto minv = std::make_shared<Matrix4x4>(
-        1./sx, 0., 0., 0.,
-        0., 1./sy, 0., 0.,
-        0., 0., 1./sz, 0.,
-        0., 0., 0., 1.
-    );
+    Transform ans;
+    ans.m_mdir[0][0] = sx;
+    ans.m_mdir[1][1] = sy;
+    ans.m_mdir[2][2] = sz;
+    ans.m_minv[0][0] = 1./sx;
+    ans.m_minv[1][1] = 1./sy;
+    ans.m_minv[2][2] = 1./sz;
+    return ans;
+}
 
-    return Transform(mdir, minv);
+static Transform makeRotation(const double r[3][3])
+{
+    double m[4][4] = {
+        {r[0][0], r[0][1], r[0][2], 0.},
+        {r[1][0], r[1][1], r[1][2], 0.},
+        {r[2][0], r[2][1], r[2][2], 0.},
+        {0., 0., 0., 1.}
+    };
+    return Transform(m);
 }
 
 // angle in radians
@@ -388,14 +409,12 @@ Transform Transform::rotateX(double angle)
     double c = cos(angle);
     double s = sin(angle);
 
-    auto mdir = std::make_shared<Matrix4x4>(
-        1., 0., 0., 0.,
-        0., c, -s, 0.,
-        0., s, c, 0.,
-        0., 0., 0., 1.
-    );
-
-    return Transform(mdir, mdir->transposed());
+    double r[3][3] = {
+        {1., 0., 0.},
+        {0., c, -s},
+        {0., s, c}
+    };
+    return makeRotation(r);
 }
 
 Transform Transform::rotateY(double angle)
@@ -403,14 +422,12 @@ Transform Transform::rotateY(double angle)
     double c = cos(angle);
     double s = sin(angle);
 
-    auto mdir = std::make_shared<Matrix4x4>(
-        c, 0., s, 0.,
-        0., 1., 0., 0.,
-        -s, 0., c, 0.,
-        0., 0., 0., 1.
-    );
-
-    return Transform(mdir, mdir->transposed());
+    double r[3][3] = {
+        {c, 0., s},
+        {0., 1., 0.},
+        {-s, 0., c}
+    };
+    return makeRotation(r);
 }
 
 Transform Transform::rotateZ(double angle)
@@ -418,14 +435,12 @@ Transform Transform::rotateZ(double angle)
     double c = cos(angle);
     double s = sin(angle);
 
-    auto mdir = std::make_shared<Matrix4x4>(
-        c, -s, 0., 0.,
-        s,  c, 0., 0.,
-        0., 0., 1., 0.,
-        0., 0., 0., 1.
-    );
-
-    return Transform(mdir, mdir->transposed());
+    double r[3][3] = {
+        {c, -s, 0.},
+        {s,  c, 0.},
+        {0., 0., 1.}
+    };
+    return makeRotation(r);
 }
 
 Transform Transform::rotate(double angle, const vec3d& axis)
@@ -434,30 +449,21 @@ Transform Transform::rotate(double angle, const vec3d& axis)
     double s = sin(angle);
     double c = cos(angle);
     double d = 1. - c;
-    double m[4][4];
-
-    m[0][0] = a.x*a.x*d + c;
-    m[0][1] = a.x*a.y*d - a.z*s;
-    m[0][2] = a.x*a.z*d + a.y*s;
-    m[0][3] = 0.;
+    double r[3][3];
 
-    m[1][0] = a.y*a.x*d + a.z*s;
-    m[1][1] = a.y*a.y*d + c;
-    m[1][2] = a.y*a.z*d - a.x*s;
-    m[1][3] = 0.;
+    r[0][0] = a.x*a.x*d + c;
+    r[0][1] = a.x*a.y*d - a.z*s;
+    r[0][2] = a.x*a.z*d + a.y*s;
 
-    m[2][0] = a.z*a.x*d - a.y*s;
-    m[2][1] = a.z*a.y*d + a.x*s;
-    m[2][2] = a.z*a.z*d + c;
-    m[2][3] = 0.;
+    r[1][0] = a.y*a.x*d + a.z*s;
+    r[1][1] = a.y*a.y*d + c;
+    r[1][2] = a.y*a.z*d - a.x*s;
 
-    m[3][0] = 0.;
-    m[3][1] = 0.;
-    m[3][2] = 0.;
-    m[3][3] = 1.;
+    r[2][0] = a.z*a.x*d - a.y*s;
+    r[2][1] = a.z*a.y*d + a.x*s;
+    r[2][2] = a.z*a.z*d + c;
 
-    auto mdir = std::make_shared<Matrix4x4>(m);
-    return Transform(mdir, mdir->transposed());
+    return makeRotation(r);
 }
 
 Transform Transform::LookAt(const vec3d& pos, const vec3d& look, const vec3d& up)
@@ -487,12 +493,11 @@ Transform Transform::LookAt(const vec3d& pos, const vec3d& look, const vec3d& up
     m[2][2] = newUp.z;
     m[3][2] = 0.;
 
-    auto camToWorld = std::make_shared<Matrix4x4>(m);
-    return Transform(camToWorld->inversed(), camToWorld);
+    return Transform(m).inversed();
 }
 
 std::ostream& operator<<(std::ostream& os, const Transform& t)
 {
-    os << *t.getMatrix();
+    os << t.getMatrix();
     return os;
 }
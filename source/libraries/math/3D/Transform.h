@@ -7,6 +7,11 @@ class Ray;
 struct Box3D;
 
 
+//! Transform is an affine transform with its inverse.
+/*!
+ * Both matrices are stored inline as 3x4 blocks, the last row is always 0 0 0 1.
+ * Copying a Transform does not allocate, so it can be kept by value in hot data.
+ */
 class TONATIUH_LIBRARIES Transform
 {
 public:
@@ -18,13 +23,10 @@ public:
         double t30, double t31, double t32, double t33
     );
     Transform(double m[4][4]);
-    Transform(Matrix4x4* m);
-    Transform(const std::shared_ptr<Matrix4x4>& mdir);
-    Transform(const std::shared_ptr<Matrix4x4>& mdir, const std::shared_ptr<Matrix4x4>& minv);
+    Transform(const Matrix4x4& m);
 
-    std::shared_ptr<Matrix4x4> getMatrix() const {return m_mdir;}
-    Transform transposed() const {return Transform(m_mdir->transposed(), m_minv->transposed());}
-    Transform inversed() const {return Transform(m_minv, m_mdir);}
+    Matrix4x4 getMatrix() const;
+    Transform inversed() const;
     vec3d getScales() const;
 
     bool SwapsHandedness() const;
@@ -63,8 +65,10 @@ public:
     static Transform LookAt(const vec3d& pos, const vec3d& look, const vec3d& up);
 
 private:
-    std::shared_ptr<Matrix4x4> m_mdir;
-    std::shared_ptr<Matrix4x4> m_minv;
+    void setDirect(const double m[3][4]); // computes the inverse
+
+    double m_mdir[3][4];
+    double m_minv[3][4];
 };
 
 
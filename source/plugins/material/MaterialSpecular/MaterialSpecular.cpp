@@ -1,7 +1,5 @@
 #include "MaterialSpecular.h"
 
-#include <Inventor/sensors/SoNodeSensor.h>
-
 #include "libraries/math/gcf.h"
 #include "libraries/math/3D/Ray.h"
 #include "libraries/math/3D/Transform.h"
@@ -31,26 +29,20 @@ MaterialSpecular::MaterialSpecular()
 
     SO_NODE_ADD_FIELD(slope, (0.002) ); // in radians
 
-    m_sensor = new SoNodeSensor(onSensor, this);
-    m_sensor->attach(this);
-}
-
-MaterialSpecular::~MaterialSpecular()
-{
-    delete m_sensor;
+    attachSensor();
 }
 
 bool MaterialSpecular::OutputRay(const Ray& rayIn, const DifferentialGeometry& dg, Random& rand, Ray& rayOut) const
 {
     // reflectivity
-    if (rand.RandomDouble() >= reflectivity.getValue()) return false;
+    if (rand.RandomDouble() >= m_reflectivity) return false;
 
     rayOut.origin = dg.point;
 
     vec3d normal;
-    double sigma = slope.getValue();
+    double sigma = m_slope;
     if (sigma > 0.) {
-        if (distribution.getValue() == Distribution::pillbox)
+        if (m_distribution == Distribution::pillbox)
         {
             double phi = gcf::TwoPi*rand.RandomDouble();
             double sinTheta = sin(sigma)*sqrt(rand.RandomDouble());
@@ -87,11 +79,13 @@ bool MaterialSpecular::OutputRay(const Ray& rayIn, const DifferentialGeometry& d
     return true;
 }
 
-void MaterialSpecular::onSensor(void* data, SoSensor*)
+void MaterialSpecular::updateCache()
 {
-    MaterialSpecular* material = (MaterialSpecular*) data;
-    if (material->reflectivity.getValue() < 0.)
-        material->reflectivity = 0.;
-    if (material->reflectivity.getValue() > 1.)
-        material->reflectivity = 1.;
+    if (reflectivity.getValue() < 0.)
+        reflectivity = 0.;
+    if (reflectivity.getValue() > 1.)
+        reflectivity = 1.;
+    m_reflectivity = reflectivity.getValue();
+    m_distribution = distribution.getValue();
+    m_slope = slope.getValue();
 }
@@ -25,10 +25,11 @@ public:
     NAME_ICON_FUNCTIONS("Specular", ":/MaterialSpecular.png")
 
 protected:
-    ~MaterialSpecular();
+    double m_reflectivity;
+    int m_distribution;
+    double m_slope;
 
-    SoNodeSensor* m_sensor;
-    static void onSensor(void* data, SoSensor*);
+    void updateCache();
 };
 
 
@@ -1,5 +1,6 @@
 #include "PhotonsFile.h"
 
+#include <cstddef>
 #include <iostream>
 
 #include <QDataStream>
@@ -9,6 +10,7 @@
 #include <QFileInfo>
 #include <QMessageBox>
 
+#include "kernel/photons/PhotonsCompact.h"
 #include "kernel/run/InstanceNode.h"
 
 
@@ -18,9 +20,11 @@ PhotonsFile::PhotonsFile():
     m_fileName("PhotonMap"),
     m_oneFile(true),
     m_nPhotonsPerFile(-1),
+    m_compact(false),
     m_fileCurrent(1),
     m_exportedPhotons(0),
-    m_photonPower(0.)
+    m_photonPower(0.),
+    m_compactCount(0)
 {
 
 }
@@ -38,6 +42,8 @@ void PhotonsFile::setParameter(QString name, QString value)
         m_oneFile = value.toDouble() < 0;
         m_nPhotonsPerFile = value.toULong();
     }
+    else if (name == parameters[3])
+        m_compact = value == "Compact";
 }
 
 bool PhotonsFile::startExport()
@@ -50,10 +56,10 @@ bool PhotonsFile::startExport()
             QDir dir(m_dirName);
             QFileInfoList infoList;
             if (m_oneFile) {
-                QString fileName = dir.absoluteFilePath(m_fileName + ".dat");
+                QString fileName = dir.absoluteFilePath(m_fileName + fileSuffix());
                 infoList << QFileInfo(fileName);
             } else {
-                QStringList filters(m_fileName + "_*.dat");
+                QStringList filters(m_fileName + "_*" + fileSuffix());
                 infoList = dir.entryInfoList(filters);
             }
 
@@ -76,8 +82,11 @@ void PhotonsFile::savePhotons(const std::vector<Photon>& photons)
     QDir dir(m_dirName);
     if (m_oneFile)
 	{
-        QString fileName = dir.absoluteFilePath(m_fileName + ".dat");
-        writePhotons(fileName, photons, 0, photons.size());
+        QString fileName = dir.absoluteFilePath(m_fileName + fileSuffix());
+        if (m_compact)
+            writePhotonsCompact(fileName, photons, 0, photons.size());
+        else
+            writePhotons(fileName, photons, 0, photons.size());
 	}
 	else
     {
@@ -87,9 +96,12 @@ void PhotonsFile::savePhotons(const std::vector<Photon>& photons)
            ulong nFile = m_exportedPhotons - m_nPhotonsPerFile*(m_fileCurrent - 1);
            nEnd = nBegin + (m_nPhotonsPerFile - nFile);
            if (nEnd > photons.size()) nEnd = photons.size();
-           QString fileName = QString("%1_%2.dat").arg(m_fileName, QString::number(m_fileCurrent));
+           QString fileName = QString("%1_%2%3").arg(m_fileName, QString::number(m_fileCurrent), fileSuffix());
            fileName = dir.absoluteFilePath(fileName);
-           writePhotons(fileName, photons, nBegin, nEnd);
+           if (m_compact)
+               writePhotonsCompact(fileName, photons, nBegin, nEnd);
+           else
+               writePhotons(fileName, photons, nBegin, nEnd);
            m_fileCurrent++;
            nBegin = nEnd;
         }
@@ -98,6 +110,15 @@ void PhotonsFile::savePhotons(const std::vector<Photon>& photons)
 
 void PhotonsFile::endExport()
 {
+    // power is known at the end
+    for (const QString& fileName : m_compactFiles) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadWrite)) continue;
+        double power = qToLittleEndian(m_photonPower);
+        file.seek(offsetof(PhotonsCompactHeader, power));
+        file.write((const char*) &power, sizeof(power));
+    }
+
     QDir dir(m_dirName);
     QString fileName = dir.absoluteFilePath(m_fileName + "_parameters.txt");
     QFile file(fileName);
@@ -105,20 +126,26 @@ void PhotonsFile::endExport()
     QTextStream out(&file);
 
     out << "START PARAMETERS\n";
-    out << "id\n";
-    if (m_saveCoordinates) {
-        out << "x\n";
-        out << "y\n";
-        out << "z\n";
-    }
-    if (m_saveSurfaceSide)
-        out << "side\n";
-    if (m_savePhotonsID) {
-        out << "previous ID\n";
-        out << "next ID\n";
+    if (m_compact) {
+        // fixed record, see PhotonsCompact.h
+        out << "format compact\n";
+        out << (m_saveCoordinatesGlobal ? "global\n" : "local\n");
+    } else {
+        out << "id\n";
+        if (m_saveCoordinates) {
+            out << "x\n";
+            out << "y\n";
+            out << "z\n";
+        }
+        if (m_saveSurfaceSide)
+            out << "side\n";
+        if (m_savePhotonsID) {
+            out << "previous ID\n";
+            out << "next ID\n";
+        }
+        if (m_saveSurfaceID)
+            out << "surface ID\n";
     }
-    if (m_saveSurfaceID)
-        out << "surface ID\n";
     out << "END PARAMETERS\n";
 
 
@@ -141,15 +168,7 @@ void PhotonsFile::writePhotons(QString fileName, const std::vector<Photon>& phot
     for (ulong n = nBegin; n < nEnd; ++n)
     {
         const Photon& photon = photons[n];
-        ulong urlId = 0;
-        if (photon.surface) {
-            urlId = m_surfaces.indexOf(photon.surface) + 1;
-            if (urlId == 0) {
-                m_surfaces << photon.surface;
-                m_surfaceWorldToObject << photon.surface->getTransform().inversed();
-                urlId = m_surfaces.size();
-            }
-        }
+        ulong urlId = findSurfaceID(photon.surface);
 
         // id
         out << double(++m_exportedPhotons);
@@ -179,3 +198,82 @@ void PhotonsFile::writePhotons(QString fileName, const std::vector<Photon>& phot
             out << double(urlId);
     }
 }
+
+quint32 PhotonsFile::findSurfaceID(InstanceNode* surface)
+{
+    if (!surface) return 0;
+    int n = surface->getId();
+    if (n < 0) {
+        // not in the traced tree, e.g. the sun
+        int k = m_surfaces.indexOf(surface);
+        if (k >= 0) return k + 1;
+    } else if (n < int(m_surfaceIDs.size())) {
+        quint32 id = m_surfaceIDs[n];
+        if (id > 0 && m_surfaces[id - 1] == surface) return id;
+    }
+
+    m_surfaces << surface;
+    m_surfaceWorldToObject << surface->getTransform().inversed();
+    quint32 id = m_surfaces.size();
+    if (n >= 0) {
+        if (n >= int(m_surfaceIDs.size()))
+            m_surfaceIDs.resize(n + 1, 0);
+        m_surfaceIDs[n] = id;
+    }
+    return id;
+}
+
+/*!
+ * Appends the photons to \a fileName in the PhotonsCompact format.
+ * All fields are saved, coordinates are global or local as in the settings.
+ */
+void PhotonsFile::writePhotonsCompact(QString fileName, const std::vector<Photon>& photons, ulong nBegin, ulong nEnd)
+{
+    QFile file(fileName);
+    if (m_compactFiles.isEmpty() || m_compactFiles.last() != fileName) {
+        if (!file.open(QIODevice::WriteOnly)) return;
+        m_compactFiles << fileName;
+        m_compactCount = 0;
+        file.write(QByteArray(sizeof(PhotonsCompactHeader), 0));
+    } else {
+        if (!file.open(QIODevice::ReadWrite)) return;
+        file.seek(file.size());
+    }
+
+    std::vector<PhotonsCompactRecord> records;
+    records.reserve(nEnd - nBegin);
+    for (ulong n = nBegin; n < nEnd; ++n)
+    {
+        const Photon& photon = photons[n];
+        quint32 urlId = findSurfaceID(photon.surface);
+
+        vec3d pos = photon.pos;
+        if (!m_saveCoordinatesGlobal && urlId > 0)
+            pos = m_surfaceWorldToObject[urlId - 1].transformPoint(pos);
+
+        quint32 info = quint32(photon.id) & PhotonsCompactRecord::IdMask;
+        if (photon.isFront) info |= PhotonsCompactRecord::FrontBit;
+        if (photon.isAbsorbed) info |= PhotonsCompactRecord::AbsorbedBit;
+
+        PhotonsCompactRecord r;
+        r.x = qToLittleEndian(float(pos.x));
+        r.y = qToLittleEndian(float(pos.y));
+        r.z = qToLittleEndian(float(pos.z));
+        r.surface = qToLittleEndian(urlId);
+        r.info = qToLittleEndian(info);
+        records.push_back(r);
+    }
+    file.write((const char*) records.data(), records.size()*sizeof(PhotonsCompactRecord));
+    m_compactCount += records.size();
+    m_exportedPhotons += records.size();
+
+    PhotonsCompactHeader header;
+    header.version = qToLittleEndian(header.version);
+    header.recordSize = qToLittleEndian(header.recordSize);
+    if (!m_saveCoordinatesGlobal) header.flags = PhotonsCompactHeader::FlagLocal;
+    header.flags = qToLittleEndian(header.flags);
+    header.count = qToLittleEndian(m_compactCount);
+    header.power = qToLittleEndian(m_photonPower);
+    file.seek(0);
+    file.write((const char*) &header, sizeof(header));
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <QMap>
 #include <QString>
 
@@ -13,7 +15,7 @@ class PhotonsFile: public PhotonsAbstract
 public:
     PhotonsFile();
 
-    static QStringList getParameterNames() {return {"ExportDirectory", "ExportFile", "FileSize"};}
+    static QStringList getParameterNames() {return {"ExportDirectory", "ExportFile", "FileSize", "Format"};}
     void setParameter(QString name, QString value);
 
     bool startExport();
@@ -24,18 +26,26 @@ public:
     NAME_ICON_FUNCTIONS("File", ":/PhotonsFile.png")
 
 private:
+    QString fileSuffix() const {return m_compact ? ".tph" : ".dat";}
+    quint32 findSurfaceID(InstanceNode* surface);
     void writePhotons(QString fileName, const std::vector<Photon>& photon, ulong nBegin, ulong nEnd);
+    void writePhotonsCompact(QString fileName, const std::vector<Photon>& photon, ulong nBegin, ulong nEnd);
 
     QString m_dirName;
     QString m_fileName;
     bool m_oneFile;
     ulong m_nPhotonsPerFile;
+    bool m_compact; // PhotonsCompact format
 
     int m_fileCurrent;
     ulong m_exportedPhotons;
     double m_photonPower;
-    QVector<InstanceNode*> m_surfaces; //? map
-	QVector<Transform> m_surfaceWorldToObject;
+    QVector<InstanceNode*> m_surfaces;
+    std::vector<quint32> m_surfaceIDs; // by InstanceNode::getId, from 1, 0 if not found yet
+    QVector<Transform> m_surfaceWorldToObject;
+
+    QStringList m_compactFiles; // for power
+    quint64 m_compactCount; // photons in last file
 };
 
 
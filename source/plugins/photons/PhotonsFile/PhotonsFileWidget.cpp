@@ -41,6 +41,8 @@ QString PhotonsFileWidget::getParameterValue(QString name) const
         else
             return QString::number(ui->photonsSpin->value());
 	}
+    else if (name == names[3])
+        return ui->formatCombo->currentText();
 	return QString();
 }
 
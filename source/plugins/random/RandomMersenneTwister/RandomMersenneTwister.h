@@ -14,6 +14,7 @@ public:
     ulong RandomUInt();
 
     void FillArray(std::vector<double>& array);
+    Random* createStream(ulong seed) const;
 
     NAME_ICON_FUNCTIONS("Mersenne-Twister", ":/RandomX.png")
 
@@ -55,6 +56,12 @@ inline void RandomMersenneTwister::FillArray(std::vector<double>& array)
         array[n] = Random01();
 }
 
+inline Random* RandomMersenneTwister::createStream(ulong seed) const
+{
+    ulong seeds[2] = {ulong(seed & 0xFFFFFFFFUL), ulong(quint64(seed) >> 32)};
+    return new RandomMersenneTwister(seeds, 2, 0);
+}
+
 inline ulong RandomMersenneTwister::Twiddle(ulong u, ulong v)
 {
     return ( ( (u & 0x80000000UL) | (v & 0x7FFFFFFFUL) ) >> 1)
@@ -22,6 +22,14 @@ public:
 
     NAME_ICON_FUNCTIONS("Elliptic", ":/ShapeElliptic.png")
     void updateShapeGL(TShapeKit* parent);
+
+protected:
+    double m_gX; // 1/aX
+    double m_gY;
+    double m_gZ;
+    double m_aZ;
+
+    void updateCache();
 };
 
 
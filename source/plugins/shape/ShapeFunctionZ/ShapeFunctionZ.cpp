@@ -29,7 +29,6 @@ void ShapeFunctionZ::initClass()
 
 ShapeFunctionZ::ShapeFunctionZ()
 {  
-    m_bvh = 0;
     SO_NODE_CONSTRUCTOR(ShapeFunctionZ);
 
     SO_NODE_ADD_FIELD( functionZ, ("(x*x + y*y)/4") );
@@ -39,23 +38,16 @@ ShapeFunctionZ::ShapeFunctionZ()
 Box3D ShapeFunctionZ::getBox(ProfileRT* profile) const
 {
     Q_UNUSED(profile)
-    if (m_bvh) return m_bvh->box();
-    return Box3D();
+    return m_mesh.box();
 }
 
 bool ShapeFunctionZ::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const
 {  
     Q_UNUSED(profile)
-    if (!m_bvh) return false;
-    double tHitT = ray.tMax;
-    DifferentialGeometry dgT;
-    if (!m_bvh->intersect(ray, &tHitT, &dgT)) return false;
-
-    if (tHit == 0 && dg == 0) return true;
+    if (tHit == 0 && dg == 0) return m_mesh.intersect(ray, 0, 0);
     if (tHit == 0 || dg == 0) gcf::SevereError("ShapeMesh::intersect");
 
-    *tHit = tHitT;
-    *dg = dgT;
+    if (!m_mesh.intersect(ray, tHit, dg)) return false;
     dg->shape = this;
     return true;
 }
@@ -84,9 +76,6 @@ void ShapeFunctionZ::updateShapeGL(TShapeKit* parent)
 
 ShapeFunctionZ::~ShapeFunctionZ()
 {
-    delete m_bvh;
-    for (Triangle* t : m_triangles)
-        delete t;
 }
 
 #include "kernel/scene/MaterialGL.h"
@@ -186,21 +175,18 @@ void ShapeFunctionZ::buildMesh(TShapeKit* parent)
 
     // fill triangles
 
-    for (Triangle* t : m_triangles)
-        delete t;
-    m_triangles.clear();
+    m_mesh.clear();
+    m_mesh.reserve(faces.size()/4);
 
     for (int n = 0; n < faces.size(); n += 4)
     {
         int iA = faces[n];
         int iB = faces[n + 1];
         int iC = faces[n + 2];
-        Triangle* triangle = new Triangle(
+        m_mesh.addTriangle(
             &vertices[iA][0], &vertices[iB][0], &vertices[iC][0],
             &normals[iA][0], &normals[iB][0], &normals[iC][0]);
-        m_triangles.push_back(triangle);
     }
 
-    if (m_bvh) delete m_bvh;
-    m_bvh = new BVH(&m_triangles);
+    m_mesh.build();
 }
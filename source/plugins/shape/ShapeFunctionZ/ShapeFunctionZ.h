@@ -6,7 +6,7 @@
 
 #include "kernel/shape/ShapeRT.h"
 #include "libraries/math/3D/Box3D.h"
-#include "BVH.h"
+#include "kernel/shape/TriangleMesh.h"
 
 
 class ShapeFunctionZ: public ShapeRT
@@ -33,8 +33,7 @@ public:
 protected:
     ~ShapeFunctionZ();
 
-    std::vector<Triangle*> m_triangles;
-    BVH* m_bvh;
+    TriangleMesh m_mesh;
 
     void buildMesh(TShapeKit* parent);
 };
@@ -22,6 +22,8 @@ ShapeHyperbolic::ShapeHyperbolic()
     SO_NODE_ADD_FIELD( aX, (1.) );
     SO_NODE_ADD_FIELD( aY, (1.) );
     SO_NODE_ADD_FIELD( aZ, (1.) );
+
+    attachSensor();
 }
 
 vec3d ShapeHyperbolic::getPoint(double u, double v) const
@@ -61,8 +63,8 @@ Box3D ShapeHyperbolic::getBox(ProfileRT* profile) const
 
 bool ShapeHyperbolic::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const
 {
-    double rZ = aZ.getValue();
-    vec3d g(1./aX.getValue(), 1./aY.getValue(), 1./rZ);
+    double rZ = m_aZ;
+    vec3d g(m_gX, m_gY, m_gZ);
     vec3d rayO = (ray.origin + vec3d(0., 0., rZ))*g;
     vec3d rayD = ray.direction()*g;
 
@@ -117,3 +119,11 @@ void ShapeHyperbolic::updateShapeGL(TShapeKit* parent)
 
     makeQuadMesh(parent, QSize(rows, columns));
 }
+
+void ShapeHyperbolic::updateCache()
+{
+    m_gX = 1./aX.getValue();
+    m_gY = 1./aY.getValue();
+    m_aZ = aZ.getValue();
+    m_gZ = 1./m_aZ;
+}
@@ -1,7 +1,5 @@
 #include "ShapeMapN.h"
 
-#include <Inventor/sensors/SoNodeSensor.h>
-
 #include "kernel/node/TonatiuhFunctions.h"
 #include "kernel/profiles/ProfileRT.h"
 #include "kernel/scene/TShapeKit.h"
@@ -36,9 +34,7 @@ ShapeMapN::ShapeMapN()
     SO_NODE_ADD_FIELD( xLimits, (-0.5f, 0.5f) );
     SO_NODE_ADD_FIELD( yLimits, (-0.5f, 0.5f) );
 
-    m_sensor = QSharedPointer<SoNodeSensor>::create(onSensor, this);
-    m_sensor->attach(this);
-    onSensor(this, 0);
+    attachSensor();
 }
 
 bool ShapeMapN::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const
@@ -81,23 +77,20 @@ void ShapeMapN::updateShapeGL(TShapeKit* parent)
     makeQuadMesh(parent, QSize(2, 2));
 }
 
-void ShapeMapN::onSensor(void* data, SoSensor*)
+void ShapeMapN::updateCache()
 {
-    ShapeMapN* shape = (ShapeMapN*) data;
-
-    shape->m_gridX = Grid(Interval(
-        shape->xLimits.getValue()[0],
-        shape->xLimits.getValue()[1]
-    ), shape->dims.getValue()[0] - 1);
-
-    shape->m_gridY = Grid(Interval(
-        shape->yLimits.getValue()[0],
-        shape->yLimits.getValue()[1]
-    ), shape->dims.getValue()[1] - 1);
-
-    Matrix2D<vec3d>& matrix = shape->m_matrixNormals;
-    matrix.resize(shape->m_gridX.divisions() + 1, shape->m_gridY.divisions() + 1);
-    SoMFVec3f& normals = shape->normals;
+    m_gridX = Grid(Interval(
+        xLimits.getValue()[0],
+        xLimits.getValue()[1]
+    ), dims.getValue()[0] - 1);
+
+    m_gridY = Grid(Interval(
+        yLimits.getValue()[0],
+        yLimits.getValue()[1]
+    ), dims.getValue()[1] - 1);
+
+    Matrix2D<vec3d>& matrix = m_matrixNormals;
+    matrix.resize(m_gridX.divisions() + 1, m_gridY.divisions() + 1);
     for (int n = 0; n < normals.getNum(); ++n)
         matrix.data()[n] = tgf::makeVector3D(*normals.getValues(n));
 }
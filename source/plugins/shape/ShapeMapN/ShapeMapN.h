@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QSharedPointer>
 #include <Inventor/fields/SoSFVec2i32.h>
 
 #include "kernel/shape/ShapeRT.h"
@@ -32,8 +31,7 @@ protected:
     Grid m_gridX;
     Grid m_gridY;
 
-    QSharedPointer<SoNodeSensor> m_sensor;
-    static void onSensor(void* data, SoSensor*);
+    void updateCache();
 };
 
 
@@ -1,7 +1,6 @@
 #include "ShapeMesh.h"
 
 #include <Inventor/sensors/SoFieldSensor.h>
-#include <Inventor/sensors/SoNodeSensor.h>
 #include <Inventor/nodes/SoCoordinate3.h>
 #include <Inventor/nodes/SoNormal.h>
 #include <Inventor/nodes/SoGroup.h>
@@ -29,7 +28,6 @@ void ShapeMesh::initClass()
 
 ShapeMesh::ShapeMesh()
 {  
-    m_bvh = 0;
     SO_NODE_CONSTRUCTOR(ShapeMesh);
     isBuiltIn = TRUE;
 
@@ -54,32 +52,22 @@ ShapeMesh::ShapeMesh()
     SO_NODE_ADD_FIELD( file, ("") );
     SO_NODE_ADD_FIELD( group, ("") );
 
-    m_sensor = QSharedPointer<SoNodeSensor>::create(onSensor, this);
-    m_sensor->setPriority(0);
-    m_sensor->attach(this);
-    onSensor(this, 0);
+    attachSensor();
 }
 
 Box3D ShapeMesh::getBox(ProfileRT* profile) const
 {
     Q_UNUSED(profile)
-    if (m_bvh) return m_bvh->box();
-    return Box3D();
+    return m_mesh.box();
 }
 
 bool ShapeMesh::intersect(const Ray& ray, double* tHit, DifferentialGeometry* dg, ProfileRT* profile) const
 {  
     Q_UNUSED(profile)
-    if (!m_bvh) return false;
-    double tHitT = ray.tMax;
-    DifferentialGeometry dgT;
-    if (!m_bvh->intersect(ray, &tHitT, &dgT)) return false;
-
-    if (tHit == 0 && dg == 0) return true;
+    if (tHit == 0 && dg == 0) return m_mesh.intersect(ray, 0, 0);
     if (tHit == 0 || dg == 0) gcf::SevereError( "ShapeMesh::intersect");
 
-    *tHit = tHitT;
-    *dg = dgT;
+    if (!m_mesh.intersect(ray, tHit, dg)) return false;
     dg->shape = this;
     return true;
 }
@@ -139,22 +127,18 @@ void ShapeMesh::updateShapeGL(TShapeKit* parent)
 
 ShapeMesh::~ShapeMesh()
 {
-    delete m_bvh;
-    for (Triangle* t : m_triangles)
-        delete t;
 }
 
 #include <QDir>
-void ShapeMesh::onSensor(void* data, SoSensor*)
+void ShapeMesh::updateCache()
 {
-    ShapeMesh* shape = (ShapeMesh*) data;
-    shape->vertices.deleteValues(0); // todo move
-    shape->normals.deleteValues(0);
-    shape->m_faceSets.clear();
+    vertices.deleteValues(0); // todo move
+    normals.deleteValues(0);
+    m_faceSets.clear();
 
-    QString fileName = shape->file.getValue().getString();
+    QString fileName = file.getValue().getString();
     if (fileName.isEmpty()) return;
-    QString groupName = shape->group.getValue().getString();
+    QString groupName = group.getValue().getString();
 
     fileName = QString("project:") + fileName;
     QFileInfo info(fileName);
@@ -186,15 +170,15 @@ void ShapeMesh::onSensor(void* data, SoSensor*)
 
 
     // mesh for rendering
-    shape->vertices.setValues(0, attrib.vertices.size()/3, (SbVec3f*) attrib.vertices.data());
-    shape->normals.setValues(0, attrib.normals.size()/3, (SbVec3f*) attrib.normals.data());
+    vertices.setValues(0, attrib.vertices.size()/3, (SbVec3f*) attrib.vertices.data());
+    normals.setValues(0, attrib.normals.size()/3, (SbVec3f*) attrib.normals.data());
 
 //    int nMax = attrib.normals.size()/3;
-//    shape->normals.setNum(nMax);
+//    normals.setNum(nMax);
 //    for (int n = 0, m = 0; n < nMax; n++, m += 3) {
 //        SbVec3f nv(&attrib.normals[m]);
 //        nv.normalize();
-//        shape->normals.set1Value(n, nv);
+//        normals.set1Value(n, nv);
 //    }
 
     for (auto& shapeGroup : shapes) {
@@ -229,15 +213,13 @@ void ShapeMesh::onSensor(void* data, SoSensor*)
         faceSet->setName(shapeGroup.name.c_str());
         faceSet->coordIndex.setValues(0, facesVertices.getNum(), facesVertices.getValues(0));
         faceSet->normalIndex.setValues(0, facesNormals.getNum(), facesNormals.getValues(0));
-        shape->m_faceSets << faceSet;
+        m_faceSets << faceSet;
     }
 
 
     // mesh for raytracing
     // quad facet are not triangulated!
-    for (Triangle* t : shape->m_triangles)
-        delete t;
-    shape->m_triangles.clear();
+    m_mesh.clear();
 
     for (auto& shapeGroup : shapes) {
         if (!groupName.isEmpty() && groupName != shapeGroup.name.c_str())
@@ -257,12 +239,10 @@ void ShapeMesh::onSensor(void* data, SoSensor*)
              vec3d nA(&attrib.normals[3*i0.normal_index]);
              vec3d nB(&attrib.normals[3*i1.normal_index]);
              vec3d nC(&attrib.normals[3*i2.normal_index]);
-             Triangle* triangle = new Triangle(vA, vB, vC, nA, nB, nC);
-             shape->m_triangles.push_back(triangle);
+             m_mesh.addTriangle(vA, vB, vC, nA, nB, nC);
              v0 += vMax;
          }
     }
 
-    if (shape->m_bvh) delete shape->m_bvh;
-    shape->m_bvh = new BVH(&shape->m_triangles, 1);
+    m_mesh.build();
 }
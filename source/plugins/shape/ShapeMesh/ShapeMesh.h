@@ -1,11 +1,10 @@
 #pragma once
 
-#include <QSharedPointer>
 #include <Inventor/fields/SoMFInt32.h>
 
 #include "kernel/shape/ShapeRT.h"
 #include "libraries/math/3D/Box3D.h"
-#include "BVH.h"
+#include "kernel/shape/TriangleMesh.h"
 
 class SoIndexedFaceSet;
 
@@ -33,11 +32,9 @@ protected:
     ~ShapeMesh();
 
     QVector<SoIndexedFaceSet*> m_faceSets;
-    std::vector<Triangle*> m_triangles;
-    BVH* m_bvh;
+    TriangleMesh m_mesh;
 
-    QSharedPointer<SoNodeSensor> m_sensor;
-    static void onSensor(void* data, SoSensor*);
+    void updateCache();
 };
 
 
@@ -1,5 +1,7 @@
 #include "SunBuie.h"
 
+#include <cmath>
+
 #include <Inventor/sensors/SoNodeSensor.h>
 #include "libraries/math/gcf.h"
 
@@ -45,12 +47,23 @@ void SunBuie::updateState(double csrValue)
     double m_integralB = (exp(m_k)*pow(1000, m_gamma)/gammaPlusTwo) * ( pow(m_thetaCS, gammaPlusTwo) - pow(m_thetaSD, gammaPlusTwo) );
     m_alpha = 1./(m_integralA + m_integralB);
 
-    m_heightSD = 1.001*pdfTheta(0.0038915695846209047);
-    m_heightCS = pdfTheta(m_thetaSD);
-
-    double areaA = m_thetaSD*m_heightSD;
-    double areaB = m_deltaThetaCSSD*m_heightCS;
-    m_probabilitySD = areaA/(areaA + areaB);
+    // knots on both sides of the jump at the edge of solar disk
+    const int nSD = 1024;
+    const int nCS = 1024;
+    std::vector<double> xs;
+    std::vector<double> pdfs;
+    for (int n = 0; n <= nSD; ++n) {
+        double theta = m_thetaSD*n/nSD;
+        if (n == nSD) theta = std::nextafter(m_thetaSD, 0.);
+        xs.push_back(theta);
+        pdfs.push_back(pdfTheta(theta));
+    }
+    for (int n = 0; n <= nCS; ++n) {
+        double theta = m_thetaSD + m_deltaThetaCSSD*n/nCS;
+        xs.push_back(theta);
+        pdfs.push_back(pdfTheta(theta));
+    }
+    m_cdf.build(xs, pdfs);
 }
 
 SunBuie::~SunBuie()
@@ -61,7 +74,7 @@ SunBuie::~SunBuie()
 vec3d SunBuie::generateRay(Random& rand) const
 {
     double phi = gcf::TwoPi*rand.RandomDouble();
-    double theta = zenithAngle(rand);
+    double theta = m_cdf.sample(rand.RandomDouble());
     double sinTheta = sin(theta);
     double cosTheta = cos(theta);
     double cosPhi = cos(phi);
@@ -100,31 +113,11 @@ SoNode* SunBuie::copy(SbBool copyConnections) const
     sun->m_thetaCS = m_thetaCS;
     sun->m_deltaThetaCSSD = m_deltaThetaCSSD;
     sun->m_alpha = m_alpha;
-    sun->m_heightSD = m_heightSD;
-    sun->m_heightCS = m_heightCS;
-    sun->m_probabilitySD = m_probabilitySD;
+    sun->m_cdf = m_cdf;
 
     return sun;
 }
 
-double SunBuie::zenithAngle(Random& rand) const
-{
-	double theta;
-	double value;
-
-    do {
-        if (rand.RandomDouble() < m_probabilitySD) {
-            theta = rand.RandomDouble()*m_thetaSD;
-            value = rand.RandomDouble()*m_heightSD;
-        } else {
-            theta = m_thetaSD + rand.RandomDouble()*m_deltaThetaCSSD;
-            value = rand.RandomDouble()*m_heightCS;
-		}
-    } while (value > pdfTheta(theta));
-
-	return theta;
-}
-
 double SunBuie::chiValue(double csr) const
 {
     if (csr > 0.145)
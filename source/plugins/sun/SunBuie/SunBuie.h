@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kernel/sun/SunShape.h"
+#include "libraries/math/1D/InverseCDF.h"
 
 
 class SunBuie: public SunShape
@@ -26,7 +27,6 @@ protected:
      double chiValue(double csr) const;
      double phi(double theta) const;
      double pdfTheta(double theta) const;
-     double zenithAngle(Random& rand) const;
      void updateState(double csrValue);
 
 	 double m_chi;
@@ -39,9 +39,8 @@ protected:
      double m_deltaThetaCSSD; // difference
 
 	 double m_alpha;
-     double m_heightSD;
-     double m_heightCS;
-     double m_probabilitySD;
+
+     InverseCDF m_cdf; // of theta
 
      static const double s_csrMin;
      static const double s_csrMax;
@@ -1,5 +1,7 @@
 #include "SunGaussian.h"
 
+#include <algorithm>
+
 #include <Inventor/sensors/SoNodeSensor.h>
 #include "libraries/math/gcf.h"
 
@@ -32,14 +34,14 @@ SoNode* SunGaussian::copy(SbBool copyConnections) const
 {
     SunGaussian* sun = dynamic_cast<SunGaussian*>(SoNode::copy(copyConnections));
     sun->m_thetaMax = m_thetaMax;
-    sun->m_h = m_h;
+    sun->m_cdf = m_cdf;
     return sun;
 }
 
 vec3d SunGaussian::generateRay(Random& rand) const
 {
     double phi = gcf::TwoPi*rand.RandomDouble();
-    double theta = zenithAngle(rand);
+    double theta = m_cdf.sample(rand.RandomDouble());
     double sinTheta = sin(theta);
     double cosTheta = cos(theta);
     double cosPhi = cos(phi);
@@ -66,24 +68,18 @@ double SunGaussian::shape(double theta) const
 void SunGaussian::updateSigma()
 {
     double s = sigma.getValue();
-    m_thetaMax = 10.*s;
-    double xMax = s; // first-order approximation
-    m_h = 1.01*pdfTheta(xMax);
-}
-
-double SunGaussian::zenithAngle(Random& rand) const
-{
-    double theta;
-    double value;
-
-    // acceptance-rejection method
-    // split in two rects like Buie
-    do {
-        theta = rand.RandomDouble()*m_thetaMax;
-        value = rand.RandomDouble()*m_h;
-    } while (value > pdfTheta(theta));
-
-    return theta;
+    m_thetaMax = std::min(10.*s, gcf::pi/2.);
+
+    // inverse cdf of theta instead of acceptance-rejection
+    const int nMax = 2048;
+    std::vector<double> xs;
+    std::vector<double> pdfs;
+    for (int n = 0; n <= nMax; ++n) {
+        double theta = m_thetaMax*n/nMax;
+        xs.push_back(theta);
+        pdfs.push_back(pdfTheta(theta));
+    }
+    m_cdf.build(xs, pdfs);
 }
 
 double SunGaussian::pdfTheta(double theta) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kernel/sun/SunShape.h"
+#include "libraries/math/1D/InverseCDF.h"
 
 
 class SunGaussian: public SunShape
@@ -24,11 +25,10 @@ protected:
     ~SunGaussian();
 
     void updateSigma();
-    double zenithAngle(Random& rand) const;
     double pdfTheta(double theta) const;
 
     double m_thetaMax; // sun disk
-    double m_h; // maximum of pdf
+    InverseCDF m_cdf; // of theta
 
     SoNodeSensor* m_sensor;
     static void onSensor(void* data, SoSensor*);